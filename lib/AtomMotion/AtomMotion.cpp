@@ -1,68 +1,86 @@
 #include "AtomMotion.h"
 
-void AtomMotion::Init() {
-    Wire.begin(25, 21);
+bool AtomMotion::Init(uint32_t frequency) {
+    // Reading motor channel 1's speed register tells whether the board
+    // answers at the requested clock
+    uint8_t probe_value = 0;
+    I2CTransaction probe;
+    probe.kind    = I2CTransaction::Kind::READ;
+    probe.address = SERVO_ADDRESS;
+    probe.reg     = 0x20;
+    probe.length  = 1;
+    probe.dest    = &probe_value;
+    return bus.start(Wire, 25, 21, frequency, &probe);
 }
 
-void AtomMotion::Write1Byte(uint8_t address, uint8_t Register_address,
-                            uint8_t data) {
-    Wire.beginTransmission(address);
-    Wire.write(Register_address);
-    Wire.write(data);
-    Wire.endTransmission();
+uint8_t AtomMotion::Write1Byte(uint8_t address, uint8_t Register_address,
+                               uint8_t data, I2CCompletion on_complete,
+                               void *context) {
+    I2CTransaction transaction;
+    transaction.address     = address;
+    transaction.reg         = Register_address;
+    transaction.length      = 1;
+    transaction.data[0]     = data;
+    transaction.on_complete = on_complete;
+    transaction.context     = context;
+    return bus.submit(transaction) != 0 ? 0 : 2;
 }
 
-void AtomMotion::Write2Byte(uint8_t address, uint8_t Register_address,
-                            uint16_t data) {
-    Wire.beginTransmission(address);
-    Wire.write(Register_address);
-    Wire.write(data >> 8);    // MSB
-    Wire.write(data & 0xFF);  // LSB
-
-    Wire.endTransmission();
+uint8_t AtomMotion::Write2Byte(uint8_t address, uint8_t Register_address,
+                               uint16_t data, I2CCompletion on_complete,
+                               void *context) {
+    I2CTransaction transaction;
+    transaction.address     = address;
+    transaction.reg         = Register_address;
+    transaction.length      = 2;
+    transaction.data[0]     = data >> 8;    // MSB
+    transaction.data[1]     = data & 0xFF;  // LSB
+    transaction.on_complete = on_complete;
+    transaction.context     = context;
+    return bus.submit(transaction) != 0 ? 0 : 2;
 }
 
 uint8_t AtomMotion::ReadBytes(uint8_t address, uint8_t subAddress,
                               uint8_t count, uint8_t *dest) {
-    Wire.beginTransmission(address);  // Initialize the Tx buffer
-    Wire.write(subAddress);           // Put slave register address in Tx buffer
-    uint8_t i = 0;
-    if (Wire.endTransmission(false) == 0 &&
-        Wire.requestFrom(address, (uint8_t)count)) {
-        while (Wire.available()) {
-            dest[i++] = Wire.read();
-        }
-        return true;
-    }
-    return false;
+    I2CTransaction transaction;
+    transaction.kind    = I2CTransaction::Kind::READ;
+    transaction.address = address;
+    transaction.reg     = subAddress;
+    transaction.length  = count;
+    transaction.dest    = dest;
+    return bus.transact(transaction) == I2CStatus::OK;
 }
 
 /*******************************************************************************/
 
-uint8_t AtomMotion::SetServoAngle(uint8_t Servo_CH, uint8_t angle) {
+uint8_t AtomMotion::SetServoAngle(uint8_t Servo_CH, uint8_t angle,
+                                  I2CCompletion on_complete, void *context) {
     uint8_t Register_address = Servo_CH - 1;
     if (Register_address > 3) return 1;
-    Write1Byte(SERVO_ADDRESS, Register_address, angle);
-    return 0;
+    return Write1Byte(SERVO_ADDRESS, Register_address, angle, on_complete,
+                      context);
 }
 
-uint8_t AtomMotion::SetServoPulse(uint8_t Servo_CH,
-                                  uint16_t width)  // 0x10        ->16
+uint8_t AtomMotion::SetServoPulse(uint8_t Servo_CH, uint16_t width,
+                                  I2CCompletion on_complete,
+                                  void *context)  // 0x10        ->16
 {
     uint8_t servo_ch         = Servo_CH - 1;
     uint8_t Register_address = 2 * servo_ch + 16;
     if (Register_address % 2 == 1 || Register_address > 32) return 1;
-    Write2Byte(SERVO_ADDRESS, Register_address, width);
-    return 0;
+    return Write2Byte(SERVO_ADDRESS, Register_address, width, on_complete,
+                      context);
 }
 
-uint8_t AtomMotion::SetMotorSpeed(uint8_t Motor_CH, int8_t speed)  // 0x10 ->16
+uint8_t AtomMotion::SetMotorSpeed(uint8_t Motor_CH, int8_t speed,
+                                  I2CCompletion on_complete,
+                                  void *context)  // 0x10 ->16
 {
     uint8_t servo_ch = Motor_CH - 1;
     if (servo_ch > 1) return 1;
     uint8_t Register_address = servo_ch + 32;
-    Write1Byte(SERVO_ADDRESS, Register_address, (uint8_t)speed);
-    return 0;
+    return Write1Byte(SERVO_ADDRESS, Register_address, (uint8_t)speed,
+                      on_complete, context);
 }
 
 uint8_t AtomMotion::ReadServoAngle(uint8_t Servo_CH) {
@@ -87,4 +105,20 @@ int8_t AtomMotion::ReadMotorSpeed(uint8_t Motor_CH) {
     uint8_t Register_address = servo_ch | 0x20;
     ReadBytes(SERVO_ADDRESS, Register_address, 1, (uint8_t *)&data);
     return data;
-}
\ No newline at end of file
+}
+
+uint8_t AtomMotion::ReadMotorSpeedAsync(uint8_t Motor_CH, int8_t *dest,
+                                        I2CCompletion on_complete,
+                                        void *context) {
+    uint8_t servo_ch = Motor_CH - 1;
+    if (servo_ch > 1) return 1;
+    I2CTransaction transaction;
+    transaction.kind        = I2CTransaction::Kind::READ;
+    transaction.address     = SERVO_ADDRESS;
+    transaction.reg         = servo_ch | 0x20;
+    transaction.length      = 1;
+    transaction.dest        = (uint8_t *)dest;
+    transaction.on_complete = on_complete;
+    transaction.context     = context;
+    return bus.submit(transaction, I2CPriority::BACKGROUND) != 0 ? 0 : 2;
+}
@@ -1,26 +1,61 @@
+#ifndef ATOM_MOTION_H
+#define ATOM_MOTION_H
+
 #include <M5Atom.h>
+#include "I2CTransactionQueue.h"
 
 #define SERVO_ADDRESS 0X38
 
 class AtomMotion {
    private:
-    void Write1Byte(uint8_t address, uint8_t Register_address, uint8_t data);
-    void Write2Byte(uint8_t address, uint8_t Register_address, uint16_t data);
+    I2CTransactionQueue bus;
+
+    uint8_t Write1Byte(uint8_t address, uint8_t Register_address, uint8_t data,
+                       I2CCompletion on_complete, void* context);
+    uint8_t Write2Byte(uint8_t address, uint8_t Register_address, uint16_t data,
+                       I2CCompletion on_complete, void* context);
     uint8_t ReadBytes(uint8_t address, uint8_t subAddress, uint8_t count,
                       uint8_t* dest);
 
    public:
-    void Init();  // sda  25     scl  21
+    // sda  25     scl  21. Falls back to 100 kHz if the board does not answer
+    // a probe read at `frequency`; GetBusFrequency() reports the clock in use.
+    bool Init(uint32_t frequency = I2CTransactionQueue::FAST_MODE_HZ);
+
+    // Set* calls only queue the write and return immediately: 0 when queued,
+    // 1 for an invalid channel, 2 when the queue is full. The optional
+    // completion reports the per-transaction bus status.
+    uint8_t SetServoAngle(uint8_t Servo_CH, uint8_t angle,
+                          I2CCompletion on_complete = nullptr,
+                          void* context = nullptr);
+
+    uint8_t SetServoPulse(uint8_t Servo_CH, uint16_t width,
+                          I2CCompletion on_complete = nullptr,
+                          void* context = nullptr);
+
+    uint8_t SetMotorSpeed(uint8_t Motor_CH, int8_t speed,
+                          I2CCompletion on_complete = nullptr,
+                          void* context = nullptr);
+
+    // Read* calls wait for the driver task to complete the transaction
+    uint8_t ReadServoAngle(uint8_t Servo_CH);
 
-    uint8_t SetServoAngle(uint8_t Servo_CH, uint8_t angle);
+    uint16_t ReadServoPulse(uint8_t Servo_CH);
 
-    uint8_t SetServoPulse(uint8_t Servo_CH, uint16_t width);
+    int8_t ReadMotorSpeed(uint8_t Motor_CH);
 
-    uint8_t SetMotorSpeed(uint8_t Motor_CH, int8_t speed);
+    // Background read-back: queued behind all writes and limited by the
+    // background bus budget. `dest` must stay valid until on_complete runs.
+    // Returns 0 when queued, 1 for an invalid channel, 2 when the queue is full.
+    uint8_t ReadMotorSpeedAsync(uint8_t Motor_CH, int8_t* dest,
+                                I2CCompletion on_complete, void* context);
 
-    uint8_t ReadServoAngle(uint8_t Servo_CH);
+    // Bus time per second that background reads may use
+    void SetBackgroundBudget(uint32_t budget_us) { bus.set_background_budget(budget_us); }
 
-    uint16_t ReadServoPulse(uint8_t Servo_CH);
+    I2CBusStats GetBusStats() const { return bus.stats(); }
 
-    int8_t ReadMotorSpeed(uint8_t Motor_CH);
-};
\ No newline at end of file
+    uint32_t GetBusFrequency() const { return bus.frequency(); }
+};
+
+#endif // ATOM_MOTION_H
@@ -0,0 +1,231 @@
+#include "I2CTransactionQueue.h"
+
+namespace {
+    struct BlockingWait {
+        StaticSemaphore_t storage;
+        SemaphoreHandle_t done;
+        I2CStatus status;
+    };
+
+    void on_blocking_complete(const I2CResult& result, void* context) {
+        BlockingWait* wait = static_cast<BlockingWait*>(context);
+        wait->status = result.status;
+        xSemaphoreGive(wait->done);
+    }
+}
+
+I2CTransactionQueue::I2CTransactionQueue()
+    : wire(nullptr), queue(nullptr), background_queue(nullptr), task(nullptr),
+      bus_frequency(0), next_id(1), background_budget_us(DEFAULT_BACKGROUND_BUDGET_US),
+      background_used_us(0), budget_window_start(0), bus_stats{},
+      stats_lock(portMUX_INITIALIZER_UNLOCKED) {
+    bus_stats.last_status = I2CStatus::NOT_STARTED;
+}
+
+I2CTransactionQueue::~I2CTransactionQueue() {
+    stop();
+}
+
+bool I2CTransactionQueue::start(TwoWire& wire, int sda, int scl, uint32_t frequency,
+                                const I2CTransaction* probe) {
+    if (task != nullptr) return true;
+
+    this->wire = &wire;
+    if (!wire.begin(sda, scl, frequency)) return false;
+
+    // begin() only validates the clock; ask the slave whether it keeps up
+    if (probe != nullptr && frequency > STANDARD_MODE_HZ && probe_bus(*probe) != I2CStatus::OK) {
+        wire.setClock(STANDARD_MODE_HZ);
+        frequency = STANDARD_MODE_HZ;
+    }
+    bus_frequency = frequency;
+
+    queue = xQueueCreate(QUEUE_DEPTH, sizeof(I2CTransaction));
+    background_queue = xQueueCreate(QUEUE_DEPTH, sizeof(I2CTransaction));
+    if (queue == nullptr || background_queue == nullptr ||
+        xTaskCreate(driver_task, "i2c_driver", DRIVER_STACK_SIZE, this,
+                    DRIVER_PRIORITY, &task) != pdPASS) {
+        task = nullptr;
+        stop();
+        return false;
+    }
+    budget_window_start = millis();
+    return true;
+}
+
+void I2CTransactionQueue::stop() {
+    if (task != nullptr) {
+        vTaskDelete(task);
+        task = nullptr;
+    }
+    if (queue != nullptr) {
+        vQueueDelete(queue);
+        queue = nullptr;
+    }
+    if (background_queue != nullptr) {
+        vQueueDelete(background_queue);
+        background_queue = nullptr;
+    }
+}
+
+uint32_t I2CTransactionQueue::submit(I2CTransaction transaction, I2CPriority priority) {
+    if (task == nullptr) return 0;
+    QueueHandle_t target = priority == I2CPriority::BACKGROUND ? background_queue : queue;
+
+    portENTER_CRITICAL(&stats_lock);
+    transaction.id = next_id++;
+    if (next_id == 0) next_id = 1;  // 0 is reserved for "not queued"
+    portEXIT_CRITICAL(&stats_lock);
+
+    if (xQueueSend(target, &transaction, 0) != pdTRUE) {
+        portENTER_CRITICAL(&stats_lock);
+        bus_stats.dropped++;
+        bus_stats.last_status = I2CStatus::QUEUE_FULL;
+        portEXIT_CRITICAL(&stats_lock);
+        return 0;
+    }
+
+    portENTER_CRITICAL(&stats_lock);
+    bus_stats.submitted++;
+    portEXIT_CRITICAL(&stats_lock);
+
+    xTaskNotifyGive(task);
+    return transaction.id;
+}
+
+I2CStatus I2CTransactionQueue::transact(I2CTransaction transaction) {
+    BlockingWait wait;
+    wait.done = xSemaphoreCreateBinaryStatic(&wait.storage);
+    wait.status = I2CStatus::NOT_STARTED;
+
+    transaction.on_complete = on_blocking_complete;
+    transaction.context = &wait;
+    if (submit(transaction) == 0) {
+        return task == nullptr ? I2CStatus::NOT_STARTED : I2CStatus::QUEUE_FULL;
+    }
+
+    // The driver always completes a dequeued transaction, so waiting forever
+    // is safe and keeps `wait` alive until the callback has run.
+    xSemaphoreTake(wait.done, portMAX_DELAY);
+    return wait.status;
+}
+
+I2CBusStats I2CTransactionQueue::stats() const {
+    portENTER_CRITICAL(&stats_lock);
+    I2CBusStats snapshot = bus_stats;
+    portEXIT_CRITICAL(&stats_lock);
+    return snapshot;
+}
+
+void I2CTransactionQueue::driver_task(void* arg) {
+    I2CTransactionQueue* self = static_cast<I2CTransactionQueue*>(arg);
+    I2CTransaction transaction;
+    bool background;
+
+    while (true) {
+        if (self->next_transaction(transaction, background)) {
+            self->run(transaction, background);
+            continue;
+        }
+
+        // Nothing runnable: sleep until the next submit, or until the budget
+        // window rolls over if background work is waiting for it
+        TickType_t wait = portMAX_DELAY;
+        if (uxQueueMessagesWaiting(self->background_queue) > 0) {
+            uint32_t elapsed = millis() - self->budget_window_start;
+            uint32_t remaining = elapsed < BUDGET_WINDOW_MS ? BUDGET_WINDOW_MS - elapsed : 0;
+            wait = pdMS_TO_TICKS(remaining) + 1;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
+
+bool I2CTransactionQueue::next_transaction(I2CTransaction& transaction, bool& background) {
+    if (xQueueReceive(queue, &transaction, 0) == pdTRUE) {
+        background = false;
+        return true;
+    }
+
+    uint32_t now = millis();
+    if (now - budget_window_start >= BUDGET_WINDOW_MS) {
+        budget_window_start = now;
+        background_used_us = 0;
+    }
+    if (background_used_us >= background_budget_us) return false;
+
+    background = true;
+    return xQueueReceive(background_queue, &transaction, 0) == pdTRUE;
+}
+
+void I2CTransactionQueue::run(const I2CTransaction& transaction, bool background) {
+    I2CResult result = {transaction.id, I2CStatus::NOT_STARTED, 0, 0};
+    do {
+        if (result.attempts > 0) delayMicroseconds(RETRY_DELAY_US);
+        uint32_t started = micros();
+        result.status = execute(transaction);
+        result.bus_time_us += micros() - started;
+        result.attempts++;
+    } while (is_retryable(result.status) && result.attempts < MAX_ATTEMPTS);
+
+    if (background) background_used_us += result.bus_time_us;
+    record(result);
+    if (transaction.on_complete != nullptr) {
+        transaction.on_complete(result, transaction.context);
+    }
+}
+
+I2CStatus I2CTransactionQueue::execute(const I2CTransaction& transaction) {
+    wire->beginTransmission(transaction.address);
+    wire->write(transaction.reg);
+
+    if (transaction.kind == I2CTransaction::Kind::WRITE) {
+        if (transaction.length > I2CTransaction::MAX_PAYLOAD) {
+            wire->endTransmission();
+            return I2CStatus::DATA_TOO_LONG;
+        }
+        wire->write(transaction.data, transaction.length);
+        return static_cast<I2CStatus>(wire->endTransmission());
+    }
+
+    // Register read: repeated start, then clock out `length` bytes
+    uint8_t status = wire->endTransmission(false);
+    if (status != 0) return static_cast<I2CStatus>(status);
+
+    uint8_t received = wire->requestFrom(transaction.address, transaction.length);
+    uint8_t i = 0;
+    while (wire->available() && i < transaction.length) {
+        transaction.dest[i++] = wire->read();
+    }
+    return received == transaction.length && i == transaction.length
+               ? I2CStatus::OK
+               : I2CStatus::SHORT_READ;
+}
+
+// Runs `probe` directly on the bus, before the driver task exists
+I2CStatus I2CTransactionQueue::probe_bus(const I2CTransaction& probe) {
+    I2CStatus status = I2CStatus::NOT_STARTED;
+    for (uint8_t attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        if (attempt > 0) delayMicroseconds(RETRY_DELAY_US);
+        status = execute(probe);
+        if (!is_retryable(status)) break;
+    }
+    return status;
+}
+
+bool I2CTransactionQueue::is_retryable(I2CStatus status) {
+    return status == I2CStatus::ADDRESS_NACK || status == I2CStatus::DATA_NACK ||
+           status == I2CStatus::SHORT_READ;
+}
+
+void I2CTransactionQueue::record(const I2CResult& result) {
+    portENTER_CRITICAL(&stats_lock);
+    if (result.status == I2CStatus::OK) {
+        bus_stats.completed++;
+    } else {
+        bus_stats.failed++;
+    }
+    bus_stats.retries += result.attempts - 1;
+    bus_stats.bus_time_us += result.bus_time_us;
+    bus_stats.last_status = result.status;
+    portEXIT_CRITICAL(&stats_lock);
+}
@@ -0,0 +1,130 @@
+#ifndef I2C_TRANSACTION_QUEUE_H
+#define I2C_TRANSACTION_QUEUE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// Completion status of a queued transaction. Values 0-5 mirror the return
+// codes of TwoWire::endTransmission().
+enum class I2CStatus : uint8_t {
+    OK = 0,
+    DATA_TOO_LONG = 1,
+    ADDRESS_NACK = 2,
+    DATA_NACK = 3,
+    BUS_ERROR = 4,
+    TIMEOUT = 5,
+    SHORT_READ = 6,
+    QUEUE_FULL = 7,
+    NOT_STARTED = 8
+};
+
+struct I2CResult {
+    uint32_t id;
+    I2CStatus status;
+    uint8_t attempts;
+    uint32_t bus_time_us;
+};
+
+// Foreground transactions always run first. Background ones only run when no
+// foreground work is queued and the background bus-time budget allows.
+enum class I2CPriority : uint8_t {
+    FOREGROUND,
+    BACKGROUND
+};
+
+// Called from the driver task once a transaction has finished (successfully
+// or not). Keep it short and never block on the bus from inside it.
+using I2CCompletion = void (*)(const I2CResult& result, void* context);
+
+struct I2CTransaction {
+    enum class Kind : uint8_t {
+        WRITE,
+        READ
+    };
+
+    static constexpr uint8_t MAX_PAYLOAD = 4;
+
+    Kind kind = Kind::WRITE;
+    uint8_t address = 0;
+    uint8_t reg = 0;
+    uint8_t length = 0;
+    uint8_t data[MAX_PAYLOAD] = {};   // Write payload
+    uint8_t* dest = nullptr;          // Read destination, must outlive the transaction
+    I2CCompletion on_complete = nullptr;
+    void* context = nullptr;
+    uint32_t id = 0;                  // Assigned by submit()
+};
+
+struct I2CBusStats {
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t retries;
+    uint32_t dropped;
+    uint64_t bus_time_us;
+    I2CStatus last_status;
+};
+
+// Queue of register transactions executed by a dedicated FreeRTOS task, so
+// callers hand off bus work without waiting for it to finish.
+class I2CTransactionQueue {
+public:
+    static constexpr uint32_t STANDARD_MODE_HZ = 100000;
+    static constexpr uint32_t FAST_MODE_HZ = 400000;
+    static constexpr uint8_t QUEUE_DEPTH = 16;
+    static constexpr uint8_t MAX_ATTEMPTS = 3;
+    static constexpr uint32_t RETRY_DELAY_US = 200;
+    static constexpr uint32_t DRIVER_STACK_SIZE = 4096;
+    static constexpr UBaseType_t DRIVER_PRIORITY = 2;
+    static constexpr uint32_t BUDGET_WINDOW_MS = 1000;
+    static constexpr uint32_t DEFAULT_BACKGROUND_BUDGET_US = 5000;  // Per window
+
+    I2CTransactionQueue();
+    ~I2CTransactionQueue();
+
+    // Starts the bus at the requested clock and spawns the driver task. The
+    // controller accepts any valid clock, so whether the slave keeps up is
+    // checked by running `probe` (a short read): if it fails above standard
+    // mode, the bus drops to STANDARD_MODE_HZ.
+    bool start(TwoWire& wire, int sda, int scl, uint32_t frequency,
+               const I2CTransaction* probe = nullptr);
+    void stop();
+
+    // Non-blocking. Returns the transaction id, or 0 if the queue is full or
+    // the driver has not been started.
+    uint32_t submit(I2CTransaction transaction,
+                    I2CPriority priority = I2CPriority::FOREGROUND);
+
+    // Submits and waits for completion. Must not be called from a completion
+    // callback.
+    I2CStatus transact(I2CTransaction transaction);
+
+    // Bus time background transactions may use per BUDGET_WINDOW_MS
+    void set_background_budget(uint32_t budget_us) { background_budget_us = budget_us; }
+
+    I2CBusStats stats() const;
+    uint32_t frequency() const { return bus_frequency; }
+
+private:
+    TwoWire* wire;
+    QueueHandle_t queue;
+    QueueHandle_t background_queue;
+    TaskHandle_t task;
+    uint32_t bus_frequency;
+    uint32_t next_id;
+    volatile uint32_t background_budget_us;
+    uint32_t background_used_us;   // Driver task only
+    uint32_t budget_window_start;  // Driver task only
+    I2CBusStats bus_stats;
+    mutable portMUX_TYPE stats_lock;
+
+    static void driver_task(void* arg);
+    bool next_transaction(I2CTransaction& transaction, bool& background);
+    void run(const I2CTransaction& transaction, bool background);
+    I2CStatus execute(const I2CTransaction& transaction);
+    I2CStatus probe_bus(const I2CTransaction& probe);
+    static bool is_retryable(I2CStatus status);
+    void record(const I2CResult& result);
+};
+
+#endif // I2C_TRANSACTION_QUEUE_H
@@ -44,6 +44,25 @@ Credentials CredentialHandler::read_credentials(const std::string& file_path) {
     if (doc["WifiPassword"].is<String>()) {
         creds.wifi_password = doc["WifiPassword"].as<String>().c_str();
     }
+    if (doc["deviceId"].is<String>()) {
+        creds.device_id = doc["deviceId"].as<String>().c_str();
+    }
+    if (doc["mqttBroker"].is<String>()) {
+        creds.mqtt_broker = doc["mqttBroker"].as<String>().c_str();
+    }
+    if (doc["mqttPort"].is<uint16_t>()) {
+        creds.mqtt_port = doc["mqttPort"].as<uint16_t>();
+    }
+    if (doc["addressedTopics"].is<bool>()) {
+        creds.addressed_topics = doc["addressedTopics"].as<bool>();
+    }
+    if (doc["groups"].is<JsonArray>()) {
+        for (JsonVariant group : doc["groups"].as<JsonArray>()) {
+            if (group.is<String>()) {
+                creds.groups.push_back(group.as<String>().c_str());
+            }
+        }
+    }
     
     return creds;
 }
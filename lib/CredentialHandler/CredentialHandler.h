@@ -2,11 +2,18 @@
 #define CREDENTIAL_HANDLER_H
 
 #include <string>
+#include <vector>
+#include <cstdint>
 
 struct Credentials {
     std::string mqtt_token;
     std::string wifi_ssid;
     std::string wifi_password;
+    std::string device_id;
+    std::vector<std::string> groups;
+    std::string mqtt_broker = "mqtt.beebotte.com";
+    uint16_t mqtt_port = 1883;
+    bool addressed_topics = false;  // Broker accepts "VRGadget/<group>/<device>/command"
 };
 
 class CredentialHandler {
@@ -0,0 +1,82 @@
+#include "DeviceAddress.h"
+#include <cstring>
+
+namespace {
+    bool segment_equals(const char* segment, size_t length, const char* value) {
+        return strlen(value) == length && strncmp(segment, value, length) == 0;
+    }
+
+    bool segment_equals(const char* segment, size_t length, const std::string& value) {
+        return value.size() == length && value.compare(0, length, segment, length) == 0;
+    }
+}
+
+DeviceAddress::DeviceAddress(const std::string& device_id, const std::vector<std::string>& groups)
+    : id(device_id), group_names(groups) {
+}
+
+std::vector<std::string> DeviceAddress::subscription_topics(const std::string& prefix) const {
+    std::vector<std::string> topics;
+    topics.reserve(group_names.size() + 1);
+    topics.push_back(prefix + "/" + WILDCARD + "/+/" + COMMAND_SUFFIX);
+    for (const std::string& group : group_names) {
+        topics.push_back(prefix + "/" + group + "/+/" + COMMAND_SUFFIX);
+    }
+    return topics;
+}
+
+bool DeviceAddress::matches_topic(const char* topic, const std::string& prefix) const {
+    size_t topic_length = strlen(topic);
+    if (topic_length <= prefix.size() || prefix.compare(0, prefix.size(), topic, prefix.size()) != 0 ||
+        topic[prefix.size()] != '/') {
+        return true;
+    }
+
+    // Split "<group>/<device>/command" in place
+    const char* group = topic + prefix.size() + 1;
+    const char* group_end = strchr(group, '/');
+    if (group_end == nullptr) return true;
+    const char* device = group_end + 1;
+    const char* device_end = strchr(device, '/');
+    if (device_end == nullptr || strcmp(device_end + 1, COMMAND_SUFFIX) != 0) return true;
+
+    return matches_group(group, group_end - group) &&
+           matches_device(device, device_end - device);
+}
+
+bool DeviceAddress::matches_target(const char* target) const {
+    const char* separator = strchr(target, '/');
+    if (separator == nullptr) {
+        return matches_device(target, strlen(target));
+    }
+    return matches_group(target, separator - target) &&
+           matches_device(separator + 1, strlen(separator + 1));
+}
+
+bool DeviceAddress::matches_payload(JsonVariantConst payload) const {
+    JsonVariantConst to = payload["to"];
+    if (to.isNull()) return true;
+    if (to.is<const char*>()) {
+        return matches_target(to.as<const char*>());
+    }
+    if (to.is<JsonArrayConst>()) {
+        for (JsonVariantConst target : to.as<JsonArrayConst>()) {
+            if (target.is<const char*>() && matches_target(target.as<const char*>())) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool DeviceAddress::matches_group(const char* name, size_t length) const {
+    if (segment_equals(name, length, WILDCARD)) return true;
+    for (const std::string& group : group_names) {
+        if (segment_equals(name, length, group)) return true;
+    }
+    return false;
+}
+
+bool DeviceAddress::matches_device(const char* name, size_t length) const {
+    return segment_equals(name, length, WILDCARD) || segment_equals(name, length, id);
+}
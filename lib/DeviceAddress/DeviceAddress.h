@@ -0,0 +1,46 @@
+#ifndef DEVICE_ADDRESS_H
+#define DEVICE_ADDRESS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ArduinoJson.h>
+
+// Identity of this gadget for group addressing. Addressed topics have the
+// form "<prefix>/<group>/<device>/command" and payload targets the form
+// "<group>/<device>" (or a bare "<device>"); either part may be "*".
+// Matching works on the caller's buffers and never allocates.
+class DeviceAddress {
+public:
+    static constexpr const char* WILDCARD = "*";
+    static constexpr const char* COMMAND_SUFFIX = "command";
+
+    DeviceAddress(const std::string& device_id, const std::vector<std::string>& groups);
+
+    // Topics that have to be subscribed to receive every message that can
+    // address this device (one per group plus the all-groups topic).
+    std::vector<std::string> subscription_topics(const std::string& prefix) const;
+
+    // True for addressed topics naming this device, and for any other topic
+    // (e.g. the legacy broadcast topic)
+    bool matches_topic(const char* topic, const std::string& prefix) const;
+
+    bool matches_target(const char* target) const;
+
+    // Applies the optional "to" field of a command payload: a target string
+    // or an array of them. Without "to" every device matches; non-string
+    // entries never match.
+    bool matches_payload(JsonVariantConst payload) const;
+
+    const std::string& device_id() const { return id; }
+    const std::vector<std::string>& groups() const { return group_names; }
+
+private:
+    std::string id;
+    std::vector<std::string> group_names;
+
+    bool matches_group(const char* name, size_t length) const;
+    bool matches_device(const char* name, size_t length) const;
+};
+
+#endif // DEVICE_ADDRESS_H
@@ -4,9 +4,10 @@
 // Static instance for callback
 MQTTClient* MQTTClient::instance = nullptr;
 
-MQTTClient::MQTTClient(const std::string& mqtt_token, const std::string& subscribe_topic)
-    : mqtt_client(wifi_client), broker_address("mqtt.beebotte.com"), port(1883), 
-      subscribe_topic(subscribe_topic), mqtt_token(mqtt_token) {
+MQTTClient::MQTTClient(const std::string& mqtt_token, const std::string& subscribe_topic,
+                       const std::string& broker_address, int port)
+    : mqtt_client(wifi_client), broker_address(broker_address), port(port), 
+      subscribe_topics{subscribe_topic}, mqtt_token(mqtt_token) {
     
     // Set static instance for callback
     instance = this;
@@ -14,6 +15,7 @@ MQTTClient::MQTTClient(const std::string& mqtt_token, const std::string& subscri
     // Configure MQTT client
     mqtt_client.setServer(broker_address.c_str(), port);
     mqtt_client.setCallback(on_message_callback);
+    mqtt_client.setBufferSize(MAX_PACKET_SIZE);
 }
 
 MQTTClient::~MQTTClient() {
@@ -24,19 +26,18 @@ MQTTClient::~MQTTClient() {
 void MQTTClient::on_message_callback(char* topic, byte* payload, unsigned int length) {
     if (instance == nullptr) return;
     
-    // Convert payload to string
-    std::string message;
-    message.reserve(length);
-    for (unsigned int i = 0; i < length; i++) {
-        message += (char)payload[i];
+    // Cheap topic check first so foreign messages are never parsed
+    if (instance->address && !instance->address->matches_topic(topic, instance->topic_prefix)) {
+        return;
     }
     
     Serial.print("Received message: ");
-    Serial.println(message.c_str());
+    Serial.write(payload, length);
+    Serial.println();
     
-    // Parse JSON and extract command
+    // Parse JSON straight from the receive buffer and extract command
     JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, message);
+    DeserializationError error = deserializeJson(doc, reinterpret_cast<const char*>(payload), length);
     
     if (error) {
         Serial.print("JSON parsing failed: ");
@@ -44,6 +45,10 @@ void MQTTClient::on_message_callback(char* topic, byte* payload, unsigned int le
         return;
     }
     
+    if (!instance->is_addressed_to_device(doc)) {
+        return;
+    }
+    
     if (doc["data"].is<std::string>()) {
         std::string command = doc["data"].as<std::string>();
         if (!command.empty()) {
@@ -51,6 +56,42 @@ void MQTTClient::on_message_callback(char* topic, byte* payload, unsigned int le
                 instance->notify_callback(command);
             }
         }
+    } else if (doc["data"].is<JsonArrayConst>()) {
+        JsonArrayConst data = doc["data"].as<JsonArrayConst>();
+        std::vector<std::string> commands;
+        commands.reserve(data.size());
+        for (JsonVariantConst entry : data) {
+            if (!entry.is<std::string>()) {
+                Serial.println("Batch rejected: commands must be strings");
+                return;
+            }
+            commands.push_back(entry.as<std::string>());
+        }
+        if (commands.empty()) return;
+        
+        if (instance->batch_callback) {
+            instance->batch_callback(commands);
+        } else if (instance->notify_callback) {
+            for (const std::string& command : commands) {
+                instance->notify_callback(command);
+            }
+        }
+    }
+}
+
+bool MQTTClient::is_addressed_to_device(const JsonDocument& doc) const {
+    // Optional "to": a target or list of targets, see DeviceAddress
+    return !address || address->matches_payload(doc.as<JsonVariantConst>());
+}
+
+void MQTTClient::set_address(const DeviceAddress& device_address, const std::string& topic_prefix,
+                             bool subscribe_addressed_topics) {
+    address.reset(new DeviceAddress(device_address));
+    this->topic_prefix = topic_prefix;
+    if (!subscribe_addressed_topics) return;
+    
+    for (const std::string& topic : address->subscription_topics(topic_prefix)) {
+        subscribe_topics.push_back(topic);
     }
 }
 
@@ -58,6 +99,10 @@ void MQTTClient::subscribe(std::function<void(const std::string&)> callback) {
     notify_callback = callback;
 }
 
+void MQTTClient::subscribe_batch(std::function<void(const std::vector<std::string>&)> callback) {
+    batch_callback = callback;
+}
+
 bool MQTTClient::reconnect() {
     unsigned int retry_count = 0;
     while (!mqtt_client.connected()) {
@@ -71,10 +116,12 @@ bool MQTTClient::reconnect() {
         if (mqtt_client.connect(clientId.c_str(), mqtt_token.c_str(), "")) {
             Serial.println("connected");
             
-            // Subscribe to topic
-            mqtt_client.subscribe(subscribe_topic.c_str());
-            Serial.print("Subscribed to: ");
-            Serial.println(subscribe_topic.c_str());
+            // Subscribe to topics
+            for (const std::string& topic : subscribe_topics) {
+                mqtt_client.subscribe(topic.c_str());
+                Serial.print("Subscribed to: ");
+                Serial.println(topic.c_str());
+            }
             
         } else {
             Serial.print("failed, rc=");
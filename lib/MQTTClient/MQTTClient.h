@@ -2,10 +2,13 @@
 #define MQTT_CLIENT_H
 
 #include <string>
+#include <memory>
 #include <functional>
+#include <vector>
 #include <WiFi.h>
 #include <PubSubClient.h>
 #include <ArduinoJson.h>
+#include "DeviceAddress.h"
 
 class MQTTClient {
 private:
@@ -13,20 +16,42 @@ private:
     PubSubClient mqtt_client;
     std::string broker_address;
     int port;
-    std::string subscribe_topic;
+    std::vector<std::string> subscribe_topics;
     std::string mqtt_token;
+    std::string topic_prefix;
+    std::unique_ptr<DeviceAddress> address;
     std::function<void(const std::string&)> notify_callback;
+    std::function<void(const std::vector<std::string>&)> batch_callback;
     
     static void on_message_callback(char* topic, byte* payload, unsigned int length);
     static MQTTClient* instance; // For static callback
     
     bool reconnect();
+    bool is_addressed_to_device(const JsonDocument& doc) const;
 
 public:
-    MQTTClient(const std::string& mqtt_token, const std::string& subscribe_topic);
+    static constexpr const char* DEFAULT_BROKER = "mqtt.beebotte.com";
+    static constexpr int DEFAULT_PORT = 1883;
+    
+    MQTTClient(const std::string& mqtt_token, const std::string& subscribe_topic,
+               const std::string& broker_address = DEFAULT_BROKER, int port = DEFAULT_PORT);
     ~MQTTClient();
     
+    // Room for batched command and telemetry payloads
+    static constexpr uint16_t MAX_PACKET_SIZE = 512;
+    
+    // Drops messages whose "to" field or addressed topic names other devices.
+    // With subscribe_addressed_topics, also subscribes to
+    // "<topic_prefix>/<group>/+/command" for this device's groups; only enable
+    // it on brokers that accept four-level topics. Call before start().
+    void set_address(const DeviceAddress& device_address, const std::string& topic_prefix,
+                     bool subscribe_addressed_topics);
+    
     void subscribe(std::function<void(const std::string&)> callback);
+    
+    // Receives the commands of an array "data" payload in order. Without it,
+    // batch commands are delivered one by one to the subscribe() callback.
+    void subscribe_batch(std::function<void(const std::vector<std::string>&)> callback);
     bool start();
     void stop();
     void publish(const std::string& topic, const std::string& data);
@@ -0,0 +1,54 @@
+#include "PeltierModel.h"
+#include <algorithm>
+#include <cmath>
+
+PeltierModel::PeltierModel(const PeltierModelParams& params)
+    : model_params(params), offset_c(0.0f) {
+}
+
+void PeltierModel::update(float drive, uint32_t elapsed_ms) {
+    if (elapsed_ms == 0 || model_params.time_constant_ms <= 0.0f) return;
+
+    // Exact step response of the first-order lag, stable for any elapsed time
+    float target_c = model_params.gain_c * std::max(-1.0f, std::min(1.0f, drive));
+    float alpha = 1.0f - std::exp(-static_cast<float>(elapsed_ms) / model_params.time_constant_ms);
+    offset_c += (target_c - offset_c) * alpha;
+}
+
+float PeltierModel::holding_duty() const {
+    if (model_params.gain_c <= 0.0f) return 0.0f;
+
+    float duty = model_params.baseline_fraction * model_params.perceptible_c / model_params.gain_c;
+    duty = std::min(duty, model_params.max_hold_duty);
+    if (model_params.full_power_w > 0.0f) {
+        duty = std::min(duty, model_params.max_hold_power_w / model_params.full_power_w);
+    }
+    return std::max(0.0f, std::min(1.0f, duty));
+}
+
+uint32_t PeltierModel::onset_latency_ms(int direction) const {
+    float current_c = direction >= 0 ? offset_c : -offset_c;
+    if (current_c >= model_params.perceptible_c) return 0;
+    if (model_params.gain_c <= model_params.perceptible_c) return UNREACHABLE_MS;
+
+    // Solve gain - (gain - current) * exp(-t / tau) = perceptible for t
+    float ratio = (model_params.gain_c - current_c) / (model_params.gain_c - model_params.perceptible_c);
+    return static_cast<uint32_t>(std::ceil(model_params.time_constant_ms * std::log(ratio)));
+}
+
+PeltierModel::SimulationResult PeltierModel::simulate(const PeltierModelParams& params,
+                                                      uint32_t prepare_ms, int direction,
+                                                      uint32_t step_ms) {
+    PeltierModel model(params);
+    float sign = direction >= 0 ? 1.0f : -1.0f;
+    if (step_ms == 0) step_ms = 1;
+
+    for (uint32_t t = 0; t < prepare_ms; t += step_ms) {
+        model.update(sign * model.holding_duty(), std::min(step_ms, prepare_ms - t));
+    }
+
+    SimulationResult result;
+    result.hold_energy_j = model.holding_power_w() * prepare_ms / 1000.0f;
+    result.onset_latency_ms = model.onset_latency_ms(direction);
+    return result;
+}
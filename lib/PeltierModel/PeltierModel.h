@@ -0,0 +1,58 @@
+#ifndef PELTIER_MODEL_H
+#define PELTIER_MODEL_H
+
+#include <cstdint>
+
+// Tunables of the open-loop thermal model. Temperatures are offsets of the
+// contact plate from ambient; positive is hotter.
+struct PeltierModelParams {
+    float gain_c = 15.0f;              // Steady-state offset at full drive
+    float time_constant_ms = 10000.0f; // First-order thermal time constant
+    float perceptible_c = 3.0f;        // Offset at which the effect is felt
+    float baseline_fraction = 0.6f;    // Holding target, fraction of perceptible_c
+    float max_hold_duty = 0.3f;        // Duty-cycle limit while holding
+    float full_power_w = 10.0f;        // Electrical power at full drive
+    float max_hold_power_w = 2.0f;     // Power limit while holding
+};
+
+// First-order lag model of a Peltier plate: the offset approaches
+// gain_c * drive with time constant time_constant_ms. Plain C++ so the same
+// code runs on the device and in host-side simulations.
+class PeltierModel {
+public:
+    static constexpr uint32_t UNREACHABLE_MS = UINT32_MAX;
+
+    struct SimulationResult {
+        uint32_t onset_latency_ms;  // From the start command to a perceptible offset
+        float hold_energy_j;        // Spent while pre-conditioning
+    };
+
+    explicit PeltierModel(const PeltierModelParams& params = PeltierModelParams());
+
+    // Advances the model with a signed drive in [-1, 1] (positive heats)
+    void update(float drive, uint32_t elapsed_ms);
+    void reset() { offset_c = 0.0f; }
+
+    float temperature_offset() const { return offset_c; }
+
+    // Holding drive magnitude: baseline target clamped to the duty-cycle
+    // and power limits
+    float holding_duty() const;
+    float holding_power_w() const { return holding_duty() * model_params.full_power_w; }
+
+    // Time for full drive in `direction` (+1 heat, -1 cool) to make the
+    // current offset perceptible
+    uint32_t onset_latency_ms(int direction) const;
+
+    const PeltierModelParams& params() const { return model_params; }
+
+    // Holds for prepare_ms from ambient, then drives fully in `direction`
+    static SimulationResult simulate(const PeltierModelParams& params, uint32_t prepare_ms,
+                                     int direction, uint32_t step_ms = 10);
+
+private:
+    PeltierModelParams model_params;
+    float offset_c;
+};
+
+#endif // PELTIER_MODEL_H
@@ -0,0 +1,122 @@
+#include "TimerWheel.h"
+
+static_assert((TimerWheel::SLOT_COUNT & (TimerWheel::SLOT_COUNT - 1)) == 0,
+              "SLOT_COUNT must be a power of two");
+
+TimerWheel::TimerWheel(uint32_t tick_ms, uint32_t now_ms)
+    : tick_period_ms(tick_ms > 0 ? tick_ms : 1), last_tick_ms(now_ms),
+      current_slot(0), active_timers(0) {
+    for (uint16_t i = 0; i < SLOT_COUNT + 2; i++) {
+        heads[i] = NO_NODE;
+    }
+    for (uint16_t i = 0; i < MAX_TIMERS; i++) {
+        nodes[i] = Node{nullptr, nullptr, 0, 0, 0, FREE_LIST, NO_NODE, NO_NODE};
+        link(i, FREE_LIST);
+    }
+}
+
+TimerWheel::TimerId TimerWheel::schedule(uint32_t now_ms, uint32_t delay_ms, Callback callback,
+                                         void* context, uint32_t arg) {
+    uint16_t index = heads[FREE_LIST];
+    if (index == NO_NODE || callback == nullptr) return INVALID_TIMER;
+
+    // Slots are relative to the last processed tick, so count the time that
+    // has passed since then too. Rounding up means a timer never fires early;
+    // it may fire up to one tick late.
+    int32_t lag_ms = static_cast<int32_t>(now_ms - last_tick_ms);
+    uint64_t due_ms = static_cast<uint64_t>(delay_ms) + (lag_ms > 0 ? lag_ms : 0);
+    uint32_t ticks = static_cast<uint32_t>((due_ms + tick_period_ms - 1) / tick_period_ms);
+    if (ticks == 0) ticks = 1;
+
+    Node& node = nodes[index];
+    node.callback = callback;
+    node.context = context;
+    node.arg = arg;
+    node.rounds = (ticks - 1) / SLOT_COUNT;
+
+    unlink(index);
+    link(index, (current_slot + ticks) & (SLOT_COUNT - 1));
+    active_timers++;
+
+    return (static_cast<TimerId>(node.generation) << 16) | (index + 1u);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint16_t index;
+    if (resolve(id, index) == nullptr) return false;
+    release(index);
+    return true;
+}
+
+void TimerWheel::advance(uint32_t now_ms) {
+    while (now_ms - last_tick_ms >= tick_period_ms) {
+        last_tick_ms += tick_period_ms;
+        current_slot = (current_slot + 1) & (SLOT_COUNT - 1);
+        process_slot();
+    }
+}
+
+void TimerWheel::process_slot() {
+    // Move due timers aside first so callbacks are free to schedule or cancel
+    uint16_t index = heads[current_slot];
+    while (index != NO_NODE) {
+        uint16_t next = nodes[index].next;
+        if (nodes[index].rounds == 0) {
+            unlink(index);
+            link(index, EXPIRING_LIST);
+        } else {
+            nodes[index].rounds--;
+        }
+        index = next;
+    }
+
+    while (heads[EXPIRING_LIST] != NO_NODE) {
+        index = heads[EXPIRING_LIST];
+        Callback callback = nodes[index].callback;
+        void* context = nodes[index].context;
+        uint32_t arg = nodes[index].arg;
+        release(index);
+        callback(context, arg);
+    }
+}
+
+TimerWheel::Node* TimerWheel::resolve(TimerId id, uint16_t& index) {
+    uint32_t slot = id & 0xFFFF;
+    if (slot == 0 || slot > MAX_TIMERS) return nullptr;
+
+    index = static_cast<uint16_t>(slot - 1);
+    Node& node = nodes[index];
+    if (node.list == FREE_LIST || node.generation != static_cast<uint16_t>(id >> 16)) {
+        return nullptr;
+    }
+    return &node;
+}
+
+void TimerWheel::link(uint16_t index, uint16_t list) {
+    Node& node = nodes[index];
+    node.list = list;
+    node.prev = NO_NODE;
+    node.next = heads[list];
+    if (node.next != NO_NODE) nodes[node.next].prev = index;
+    heads[list] = index;
+}
+
+void TimerWheel::unlink(uint16_t index) {
+    Node& node = nodes[index];
+    if (node.prev != NO_NODE) {
+        nodes[node.prev].next = node.next;
+    } else {
+        heads[node.list] = node.next;
+    }
+    if (node.next != NO_NODE) nodes[node.next].prev = node.prev;
+    node.prev = NO_NODE;
+    node.next = NO_NODE;
+}
+
+void TimerWheel::release(uint16_t index) {
+    unlink(index);
+    nodes[index].generation++;
+    nodes[index].callback = nullptr;
+    link(index, FREE_LIST);
+    active_timers--;
+}
@@ -0,0 +1,66 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Hashed timer wheel with a fixed pool of timers. Scheduling and cancelling
+// are O(1); each tick only visits the timers hashed into the current slot.
+// Driven by advance() from the caller's loop, so callbacks run in that
+// context and never allocate.
+class TimerWheel {
+public:
+    using Callback = void (*)(void* context, uint32_t arg);
+    using TimerId = uint32_t;
+
+    static constexpr TimerId INVALID_TIMER = 0;
+    static constexpr uint16_t SLOT_COUNT = 64;   // Must be a power of two
+    static constexpr uint16_t MAX_TIMERS = 16;
+
+    TimerWheel(uint32_t tick_ms, uint32_t now_ms);
+
+    // Fires no earlier than now_ms + delay_ms, even if advance() has not run
+    // for a while. Returns INVALID_TIMER when every timer in the pool is in use.
+    TimerId schedule(uint32_t now_ms, uint32_t delay_ms, Callback callback, void* context,
+                     uint32_t arg);
+
+    // Returns false if the timer already fired or was cancelled
+    bool cancel(TimerId id);
+
+    // Processes every tick elapsed since the previous call
+    void advance(uint32_t now_ms);
+
+    uint32_t tick_ms() const { return tick_period_ms; }
+    size_t active_count() const { return active_timers; }
+
+private:
+    static constexpr uint16_t NO_NODE = 0xFFFF;
+    static constexpr uint16_t FREE_LIST = SLOT_COUNT;       // Unused timers
+    static constexpr uint16_t EXPIRING_LIST = SLOT_COUNT + 1;  // Due this tick
+
+    struct Node {
+        Callback callback;
+        void* context;
+        uint32_t arg;
+        uint32_t rounds;      // Full wheel turns left before expiring
+        uint16_t generation;  // Invalidates stale TimerIds
+        uint16_t list;        // Slot index, FREE_LIST or EXPIRING_LIST
+        uint16_t prev;
+        uint16_t next;
+    };
+
+    Node nodes[MAX_TIMERS];
+    uint16_t heads[SLOT_COUNT + 2];
+    uint32_t tick_period_ms;
+    uint32_t last_tick_ms;
+    uint16_t current_slot;
+    size_t active_timers;
+
+    void link(uint16_t index, uint16_t list);
+    void unlink(uint16_t index);
+    void release(uint16_t index);
+    void process_slot();
+    Node* resolve(TimerId id, uint16_t& index);
+};
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,105 @@
+#include "CommandDispatcher.h"
+#include <iostream>
+
+const CommandDispatcher::CommandEntry CommandDispatcher::COMMANDS[] = {
+    {"start_heating", true, [](CommandsHandler& handler, uint32_t duration_ms) { handler.start_heating(duration_ms); }},
+    {"finish_heating", false, [](CommandsHandler& handler, uint32_t) { handler.finish_heating(); }},
+    {"start_cooling", true, [](CommandsHandler& handler, uint32_t duration_ms) { handler.start_cooling(duration_ms); }},
+    {"finish_cooling", false, [](CommandsHandler& handler, uint32_t) { handler.finish_cooling(); }},
+    {"start_splash", true, [](CommandsHandler& handler, uint32_t duration_ms) { handler.start_splash(duration_ms); }},
+    {"finish_splash", false, [](CommandsHandler& handler, uint32_t) { handler.finish_splash(); }},
+    {"prepare_heating", true, [](CommandsHandler& handler, uint32_t duration_ms) { handler.prepare_heating(duration_ms); }},
+    {"prepare_cooling", true, [](CommandsHandler& handler, uint32_t duration_ms) { handler.prepare_cooling(duration_ms); }},
+};
+
+CommandDispatcher::CommandDispatcher(CommandsHandler& commands_handler)
+    : commands_handler(commands_handler) {
+}
+
+bool CommandDispatcher::call_command(const std::string& command) {
+    std::cout << "[Info] Handling command: " << command << std::endl;
+
+    uint32_t duration_ms;
+    const CommandEntry* entry = parse_command(command, duration_ms);
+    if (entry == nullptr) {
+        std::cout << "[Error] Unknown command or invalid arguments: " << command << std::endl;
+        return false;
+    }
+
+    std::cout << "[Info] Executing " << entry->name << " command" << std::endl;
+    entry->run(commands_handler, duration_ms);
+    return true;
+}
+
+bool CommandDispatcher::call_batch(const std::vector<std::string>& commands) {
+    for (const std::string& command : commands) {
+        if (!is_valid_command(command)) {
+            std::cout << "[Error] Batch rejected, invalid command: " << command << std::endl;
+            return false;
+        }
+    }
+
+    commands_handler.begin_batch();
+    for (const std::string& command : commands) {
+        call_command(command);
+    }
+    commands_handler.commit_batch();
+    return true;
+}
+
+bool CommandDispatcher::is_valid_command(const std::string& command) {
+    uint32_t duration_ms;
+    return parse_command(command, duration_ms) != nullptr;
+}
+
+// Splits "start_heating for=800ms" into its table entry and duration
+const CommandDispatcher::CommandEntry* CommandDispatcher::parse_command(const std::string& command,
+                                                                        uint32_t& duration_ms) {
+    duration_ms = 0;
+    size_t separator = command.find(' ');
+    std::string name = command.substr(0, separator);
+
+    const CommandEntry* entry = nullptr;
+    for (const CommandEntry& candidate : COMMANDS) {
+        if (name == candidate.name) {
+            entry = &candidate;
+            break;
+        }
+    }
+    if (entry == nullptr || separator == std::string::npos) return entry;
+    if (!entry->accepts_duration) return nullptr;
+
+    std::string argument = command.substr(separator + 1);
+    const std::string duration_prefix = "for=";
+    if (argument.compare(0, duration_prefix.size(), duration_prefix) != 0 ||
+        !parse_duration_ms(argument.substr(duration_prefix.size()), duration_ms)) {
+        return nullptr;
+    }
+    return entry;
+}
+
+// Parses "800ms", "2s" or a bare millisecond count. Zero and durations above
+// MAX_DURATION_MS are rejected.
+bool CommandDispatcher::parse_duration_ms(const std::string& text, uint32_t& duration_ms) {
+    size_t digits = 0;
+    uint32_t value = 0;
+    while (digits < text.size() && digits < 9 && text[digits] >= '0' && text[digits] <= '9') {
+        value = value * 10 + (text[digits] - '0');
+        digits++;
+    }
+    if (digits == 0) return false;
+
+    std::string unit = text.substr(digits);
+    uint32_t multiplier;
+    if (unit.empty() || unit == "ms") {
+        multiplier = 1;
+    } else if (unit == "s") {
+        multiplier = 1000;
+    } else {
+        return false;
+    }
+
+    if (value == 0 || value > MAX_DURATION_MS / multiplier) return false;
+    duration_ms = value * multiplier;
+    return true;
+}
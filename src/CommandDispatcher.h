@@ -0,0 +1,40 @@
+#ifndef COMMAND_DISPATCHER_H
+#define COMMAND_DISPATCHER_H
+
+#include <string>
+#include <vector>
+#include "CommandsHandler.h"
+
+// Parses text commands ("start_heating for=800ms") and runs them against a
+// CommandsHandler. Validation and dispatch share one command table.
+class CommandDispatcher {
+public:
+    static constexpr uint32_t MAX_DURATION_MS = 3600000;
+
+    explicit CommandDispatcher(CommandsHandler& commands_handler);
+
+    // Returns false for unknown commands and invalid arguments
+    bool call_command(const std::string& command);
+
+    // Applies all commands as one transaction: either every command is valid
+    // and the final state is written once, or nothing changes
+    bool call_batch(const std::vector<std::string>& commands);
+
+    static bool is_valid_command(const std::string& command);
+
+private:
+    struct CommandEntry {
+        const char* name;
+        bool accepts_duration;  // Only commands that switch something on
+        void (*run)(CommandsHandler& handler, uint32_t duration_ms);
+    };
+
+    static const CommandEntry COMMANDS[];
+
+    CommandsHandler& commands_handler;
+
+    static const CommandEntry* parse_command(const std::string& command, uint32_t& duration_ms);
+    static bool parse_duration_ms(const std::string& text, uint32_t& duration_ms);
+};
+
+#endif // COMMAND_DISPATCHER_H
@@ -1,63 +1,280 @@
 #include "CommandsHandler.h"
+#include <cmath>
 #include <iostream>
 
 CommandsHandler::CommandsHandler() 
-    : is_heating(false), is_cooling(false), is_splashing(false) {
-    atom_motion.Init();
+    : is_heating(false), is_cooling(false), is_splashing(false),
+      is_preheating(false), is_precooling(false),
+      batch_depth(0), applied_speeds{STOP_VALUE, STOP_VALUE}, write_count(0),
+      writes_pending(false), write_errors{}, dirty_channels(0),
+      timer_wheel(TIMER_TICK_MS, millis()),
+      channel_timers{TimerWheel::INVALID_TIMER, TimerWheel::INVALID_TIMER},
+      max_on_ms{DEFAULT_PELTIER_MAX_ON_MS, DEFAULT_SPLASH_MAX_ON_MS},
+      last_model_update_ms(millis()) {
+    if (atom_motion.Init()) {
+        std::cout << "[Info] [CommandsHandler] I2C bus running at "
+                  << atom_motion.GetBusFrequency() << " Hz" << std::endl;
+    } else {
+        std::cout << "[Error] [CommandsHandler] Failed to start I2C driver" << std::endl;
+    }
     update_led_color();
     std::cout << "[Info] [CommandsHandler] initialized" << std::endl;
 }
 
-void CommandsHandler::start_heating() {
-    atom_motion.SetMotorSpeed(PELTIER_CHANNEL, HEATING_VALUE);
+void CommandsHandler::start_heating(uint32_t duration_ms) {
+    log_onset_estimate("start_heating", 1);
+    arm_channel_timer(PELTIER_CHANNEL, duration_ms);
     is_heating = true;
     is_cooling = false;
-    update_led_color();
+    is_preheating = false;
+    is_precooling = false;
+    apply_state();
     std::cout << "[Info] [start_heating] command executed" << std::endl;
 }
 
 void CommandsHandler::finish_heating() {
-    if (is_heating) {
-        atom_motion.SetMotorSpeed(PELTIER_CHANNEL, STOP_VALUE);
+    if (is_heating || is_preheating) {
+        disarm_channel_timer(PELTIER_CHANNEL);
         is_heating = false;
-        update_led_color();
+        is_preheating = false;
+        apply_state();
     }
     std::cout << "[Info] [finish_heating] command executed" << std::endl;
 }
 
-void CommandsHandler::start_cooling() {
-    atom_motion.SetMotorSpeed(PELTIER_CHANNEL, COOLING_VALUE);
+void CommandsHandler::start_cooling(uint32_t duration_ms) {
+    log_onset_estimate("start_cooling", -1);
+    arm_channel_timer(PELTIER_CHANNEL, duration_ms);
     is_cooling = true;
     is_heating = false;
-    update_led_color();
+    is_preheating = false;
+    is_precooling = false;
+    apply_state();
     std::cout << "[Info] [start_cooling] command executed" << std::endl;
 }
 
 void CommandsHandler::finish_cooling() {
-    if (is_cooling) {
-        atom_motion.SetMotorSpeed(PELTIER_CHANNEL, STOP_VALUE);
+    if (is_cooling || is_precooling) {
+        disarm_channel_timer(PELTIER_CHANNEL);
         is_cooling = false;
-        update_led_color();
+        is_precooling = false;
+        apply_state();
     }
     std::cout << "[Info] [finish_cooling] command executed" << std::endl;
 }
 
-void CommandsHandler::start_splash() {
-    atom_motion.SetMotorSpeed(SPLASH_CHANNEL, SPLASH_VALUE);
+void CommandsHandler::start_splash(uint32_t duration_ms) {
+    arm_channel_timer(SPLASH_CHANNEL, duration_ms);
     is_splashing = true;
-    update_led_color();
+    apply_state();
     std::cout << "[Info] [start_splash] command executed" << std::endl;
 }
 
 void CommandsHandler::finish_splash() {
     if (is_splashing) {
-        atom_motion.SetMotorSpeed(SPLASH_CHANNEL, STOP_VALUE);
+        disarm_channel_timer(SPLASH_CHANNEL);
         is_splashing = false;
-        update_led_color();
+        apply_state();
     }
     std::cout << "[Info] [finish_splash] command executed" << std::endl;
 }
 
+void CommandsHandler::prepare_heating(uint32_t duration_ms) {
+    arm_channel_timer(PELTIER_CHANNEL, duration_ms);
+    is_preheating = true;
+    is_precooling = false;
+    is_heating = false;
+    is_cooling = false;
+    apply_state();
+    std::cout << "[Info] [prepare_heating] command executed, holding at "
+              << thermal_model.holding_power_w() << " W" << std::endl;
+}
+
+void CommandsHandler::prepare_cooling(uint32_t duration_ms) {
+    arm_channel_timer(PELTIER_CHANNEL, duration_ms);
+    is_precooling = true;
+    is_preheating = false;
+    is_heating = false;
+    is_cooling = false;
+    apply_state();
+    std::cout << "[Info] [prepare_cooling] command executed, holding at "
+              << thermal_model.holding_power_w() << " W" << std::endl;
+}
+
+void CommandsHandler::begin_batch() {
+    batch_depth++;
+}
+
+void CommandsHandler::commit_batch() {
+    if (batch_depth == 0) return;
+    batch_depth--;
+    apply_state();
+}
+
+bool CommandsHandler::read_back_channel(uint8_t channel, int8_t* dest,
+                                        I2CCompletion on_complete, void* context) {
+    return atom_motion.ReadMotorSpeedAsync(channel, dest, on_complete, context) == 0;
+}
+
+void CommandsHandler::reapply_channel(uint8_t channel) {
+    if (channel < 1 || channel > CHANNEL_COUNT) return;
+    int8_t speed = desired_speed(channel);
+    if (write_channel(channel, speed)) {
+        applied_speeds[channel - 1] = speed;
+        dirty_channels &= ~(1u << (channel - 1));
+    }
+}
+
+void CommandsHandler::set_max_on_time(uint8_t channel, uint32_t max_on_ms) {
+    if (channel < 1 || channel > CHANNEL_COUNT) return;
+    this->max_on_ms[channel - 1] = max_on_ms;
+}
+
+void CommandsHandler::set_thermal_model(const PeltierModelParams& params) {
+    thermal_model = PeltierModel(params);
+    apply_state();  // The holding intensity may have changed
+}
+
+void CommandsHandler::tick(uint32_t now_ms) {
+    // Heating drives the motor channel negative; the model counts heat as positive
+    float drive = -static_cast<float>(applied_speeds[PELTIER_CHANNEL - 1]) / COOLING_VALUE;
+    thermal_model.update(drive, now_ms - last_model_update_ms);
+    last_model_update_ms = now_ms;
+    
+    timer_wheel.advance(now_ms);
+    check_write_errors();
+    
+    if (writes_pending && batch_depth == 0) {
+        flush_channels();
+    }
+}
+
+int8_t CommandsHandler::holding_speed() const {
+    // Round down so the holding drive never exceeds the duty-cycle or power
+    // limit. The smallest step is only used where both limits allow it.
+    float duty = thermal_model.holding_duty();
+    int8_t speed = static_cast<int8_t>(std::floor(duty * COOLING_VALUE));
+    if (speed == 0 && duty > 0.0f) {
+        const PeltierModelParams& params = thermal_model.params();
+        float min_duty = 1.0f / COOLING_VALUE;
+        if (min_duty <= params.max_hold_duty &&
+            min_duty * params.full_power_w <= params.max_hold_power_w) {
+            speed = 1;
+        }
+    }
+    return speed;
+}
+
+void CommandsHandler::log_onset_estimate(const char* command, int direction) const {
+    std::cout << "[Info] [" << command << "] estimated onset in "
+              << thermal_model.onset_latency_ms(direction) << " ms (plate offset "
+              << thermal_model.temperature_offset() << " C)" << std::endl;
+}
+
+void CommandsHandler::arm_channel_timer(uint8_t channel, uint32_t duration_ms) {
+    disarm_channel_timer(channel);
+    
+    uint32_t limit_ms = max_on_ms[channel - 1];
+    uint32_t timeout_ms = duration_ms;
+    if (limit_ms > 0 && (timeout_ms == 0 || timeout_ms > limit_ms)) {
+        timeout_ms = limit_ms;
+    }
+    if (timeout_ms == 0) return;
+    
+    channel_timers[channel - 1] = timer_wheel.schedule(millis(), timeout_ms, on_channel_timeout, this, channel);
+    if (channel_timers[channel - 1] == TimerWheel::INVALID_TIMER) {
+        std::cout << "[Error] [arm_channel_timer] No free timer for channel "
+                  << static_cast<int>(channel) << std::endl;
+    }
+}
+
+void CommandsHandler::disarm_channel_timer(uint8_t channel) {
+    timer_wheel.cancel(channel_timers[channel - 1]);
+    channel_timers[channel - 1] = TimerWheel::INVALID_TIMER;
+}
+
+void CommandsHandler::on_channel_timeout(void* context, uint32_t channel) {
+    CommandsHandler* self = static_cast<CommandsHandler*>(context);
+    self->channel_timers[channel - 1] = TimerWheel::INVALID_TIMER;
+    std::cout << "[Info] [auto_off] channel " << channel << " timed out" << std::endl;
+    
+    if (channel == PELTIER_CHANNEL) {
+        self->finish_heating();
+        self->finish_cooling();
+    } else if (channel == SPLASH_CHANNEL) {
+        self->finish_splash();
+    }
+}
+
+int8_t CommandsHandler::desired_speed(uint8_t channel) const {
+    if (channel == PELTIER_CHANNEL) {
+        if (is_heating) return HEATING_VALUE;
+        if (is_cooling) return COOLING_VALUE;
+        if (is_preheating) return -holding_speed();
+        if (is_precooling) return holding_speed();
+    } else if (channel == SPLASH_CHANNEL) {
+        if (is_splashing) return SPLASH_VALUE;
+    }
+    return STOP_VALUE;
+}
+
+void CommandsHandler::apply_state() {
+    // Inside a batch only the flags change; the hardware sees the final state
+    if (batch_depth > 0) return;
+    
+    flush_channels();
+    update_led_color();
+}
+
+void CommandsHandler::flush_channels() {
+    // Only changed channels are written. A write that could not be queued
+    // leaves the channel dirty, and tick() retries it.
+    writes_pending = false;
+    for (uint8_t channel = 1; channel <= CHANNEL_COUNT; channel++) {
+        int8_t speed = desired_speed(channel);
+        uint8_t channel_bit = 1u << (channel - 1);
+        if (speed == applied_speeds[channel - 1] && !(dirty_channels & channel_bit)) continue;
+        if (write_channel(channel, speed)) {
+            applied_speeds[channel - 1] = speed;
+            dirty_channels &= ~channel_bit;
+        } else {
+            writes_pending = true;
+        }
+    }
+}
+
+bool CommandsHandler::write_channel(uint8_t channel, int8_t value) {
+    // Queued for the I2C driver task; bus failures come back through
+    // on_write_complete() and are retried from tick()
+    if (atom_motion.SetMotorSpeed(channel, value, on_write_complete, &write_errors[channel - 1]) != 0) {
+        std::cout << "[Error] [write_channel] Failed to queue write for channel "
+                  << static_cast<int>(channel) << std::endl;
+        return false;
+    }
+    write_count++;
+    return true;
+}
+
+// Runs on the I2C driver task, so it only records the failure
+void CommandsHandler::on_write_complete(const I2CResult& result, void* context) {
+    if (result.status == I2CStatus::OK) return;
+    static_cast<std::atomic<uint8_t>*>(context)->store(static_cast<uint8_t>(result.status),
+                                                       std::memory_order_release);
+}
+
+void CommandsHandler::check_write_errors() {
+    for (uint8_t channel = 1; channel <= CHANNEL_COUNT; channel++) {
+        uint8_t status = write_errors[channel - 1].exchange(0, std::memory_order_acquire);
+        if (status == 0) continue;
+        
+        std::cout << "[Error] [write_channel] Write to channel " << static_cast<int>(channel)
+                  << " failed with I2C status " << static_cast<int>(status) << "; retrying"
+                  << std::endl;
+        dirty_channels |= 1u << (channel - 1);
+        writes_pending = true;
+    }
+}
+
 void CommandsHandler::update_led_color() {
     uint32_t color = LED_OFF;
     
@@ -72,6 +289,10 @@ void CommandsHandler::update_led_color() {
         color = LED_BLUE;
     } else if (is_splashing) {
         color = LED_GREEN;
+    } else if (is_preheating) {
+        color = LED_DIM_RED;
+    } else if (is_precooling) {
+        color = LED_DIM_BLUE;
     }
     
     M5.dis.drawpix(0, color);
@@ -1,9 +1,12 @@
 #ifndef COMMANDS_HANDLER_H
 #define COMMANDS_HANDLER_H
 
+#include <atomic>
 #include <string>
 #include <M5Atom.h>
 #include "AtomMotion.h"
+#include "TimerWheel.h"
+#include "PeltierModel.h"
 
 class CommandsHandler {
 public:
@@ -21,6 +24,12 @@ public:
     static constexpr int8_t COOLING_VALUE = 127;
     static constexpr int8_t SPLASH_VALUE = 127;
     static constexpr int8_t STOP_VALUE = 0;
+    static constexpr uint8_t CHANNEL_COUNT = 2;
+    
+    // Auto-off timing. A max on-time of 0 disables the safety cutoff.
+    static constexpr uint32_t TIMER_TICK_MS = 10;
+    static constexpr uint32_t DEFAULT_PELTIER_MAX_ON_MS = 120000;
+    static constexpr uint32_t DEFAULT_SPLASH_MAX_ON_MS = 60000;
     
     // LED colors
     static constexpr uint32_t LED_RED = 0xff0000;      // Heating only
@@ -28,32 +37,105 @@ public:
     static constexpr uint32_t LED_GREEN = 0x00ff00;    // Splash only
     static constexpr uint32_t LED_YELLOW = 0xffff00;    // Heating + Splash (red + green)
     static constexpr uint32_t LED_CYAN = 0x00ffff;  // Cooling + Splash (blue + green)
+    static constexpr uint32_t LED_DIM_RED = 0x200000;  // Preparing heating
+    static constexpr uint32_t LED_DIM_BLUE = 0x000020; // Preparing cooling
     static constexpr uint32_t LED_OFF = 0x000000;      // Off
 
     CommandsHandler();
     
-    // Public interface methods
-    void start_heating();
+    // Public interface methods. A non-zero duration switches the effect off
+    // automatically, capped by the channel's max on-time.
+    void start_heating(uint32_t duration_ms = 0);
     void finish_heating();
-    void start_cooling();
+    void start_cooling(uint32_t duration_ms = 0);
     void finish_cooling();
-    void start_splash();
+    void start_splash(uint32_t duration_ms = 0);
     void finish_splash();
     
+    // Holds the Peltier at a low, power-limited intensity so a later start_*
+    // begins from a pre-conditioned plate. Ended by start_* or finish_*.
+    void prepare_heating(uint32_t duration_ms = 0);
+    void prepare_cooling(uint32_t duration_ms = 0);
+    
+    // Commands issued between begin_batch() and commit_batch() only update
+    // state; the combined result is written to the hardware and LED once.
+    void begin_batch();
+    void commit_batch();
+    
+    void set_max_on_time(uint8_t channel, uint32_t max_on_ms);
+    void set_thermal_model(const PeltierModelParams& params);
+    
+    // Services expired effect timers, the thermal model and writes that could
+    // not be queued earlier; call from the main loop
+    void tick(uint32_t now_ms);
+    
     // Status query methods
     bool is_heating_active() const { return is_heating; }
     bool is_cooling_active() const { return is_cooling; }
     bool is_splash_active() const { return is_splashing; }
+    bool is_preparing() const { return is_preheating || is_precooling; }
+    float estimated_plate_offset() const { return thermal_model.temperature_offset(); }
+    I2CBusStats bus_stats() const { return atom_motion.GetBusStats(); }
+    
+    // Read-back support for HealthMonitor. desired_speed() is what the current
+    // state calls for, applied_speed() the value last queued. write_generation()
+    // changes with every queued write, so a read that straddles a write can be
+    // discarded. reapply_channel() writes the desired value.
+    int8_t desired_speed(uint8_t channel) const;
+    int8_t applied_speed(uint8_t channel) const { return applied_speeds[channel - 1]; }
+    uint32_t write_generation() const { return write_count; }
+    bool read_back_channel(uint8_t channel, int8_t* dest, I2CCompletion on_complete, void* context);
+    void reapply_channel(uint8_t channel);
+    void set_readback_budget(uint32_t budget_us) { atom_motion.SetBackgroundBudget(budget_us); }
 
 private:
     // State variables
     bool is_heating;
     bool is_cooling;
     bool is_splashing;
+    bool is_preheating;
+    bool is_precooling;
+    
+    // Open batch count and the motor values last sent, indexed by channel - 1
+    uint8_t batch_depth;
+    int8_t applied_speeds[CHANNEL_COUNT];
+    uint32_t write_count;
+    bool writes_pending;
+    
+    // Bus status of the latest failed write per channel, set from the I2C
+    // driver task and consumed by tick(). Channels in dirty_channels are
+    // written again even if applied_speeds already matches.
+    std::atomic<uint8_t> write_errors[CHANNEL_COUNT];
+    uint8_t dirty_channels;
     
     // Hardware interface
     AtomMotion atom_motion;
     
+    // Auto-off timers, indexed by channel - 1
+    TimerWheel timer_wheel;
+    TimerWheel::TimerId channel_timers[CHANNEL_COUNT];
+    uint32_t max_on_ms[CHANNEL_COUNT];
+    
+    // Open-loop estimate of the Peltier plate temperature
+    PeltierModel thermal_model;
+    uint32_t last_model_update_ms;
+    int8_t holding_speed() const;
+    void log_onset_estimate(const char* command, int direction) const;
+    
+    // Helper methods to (re)arm and cancel a channel's auto-off timer
+    void arm_channel_timer(uint8_t channel, uint32_t duration_ms);
+    void disarm_channel_timer(uint8_t channel);
+    static void on_channel_timeout(void* context, uint32_t channel);
+    
+    // Helper methods to flush the current state to the hardware
+    void apply_state();
+    void flush_channels();
+    
+    // Helper methods to queue a motor channel write and collect its result
+    bool write_channel(uint8_t channel, int8_t value);
+    static void on_write_complete(const I2CResult& result, void* context);
+    void check_write_errors();
+    
     // Helper method to update LED based on current state
     void update_led_color();
 };
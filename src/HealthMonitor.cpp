@@ -0,0 +1,109 @@
+#include "HealthMonitor.h"
+#include <ArduinoJson.h>
+#include <iostream>
+
+HealthMonitor::HealthMonitor(CommandsHandler& commands_handler)
+    : commands_handler(commands_handler), sample_interval_ms(DEFAULT_SAMPLE_INTERVAL_MS),
+      last_sample_ms(0), sample_head(0), sample_count(0), mismatches(0), dropped(0), ok_reads(0) {
+    for (ChannelRead& read : reads) {
+        read.state.store(IDLE);
+        read.value = 0;
+        read.status = I2CStatus::NOT_STARTED;
+        read.generation = 0;
+    }
+}
+
+void HealthMonitor::poll(uint32_t now_ms) {
+    for (uint8_t channel = 1; channel <= CommandsHandler::CHANNEL_COUNT; channel++) {
+        if (reads[channel - 1].state.load(std::memory_order_acquire) == DONE) {
+            check_channel(channel, now_ms);
+        }
+    }
+
+    if (now_ms - last_sample_ms < sample_interval_ms) return;
+    last_sample_ms = now_ms;
+
+    for (uint8_t channel = 1; channel <= CommandsHandler::CHANNEL_COUNT; channel++) {
+        ChannelRead& read = reads[channel - 1];
+        if (read.state.load(std::memory_order_acquire) != IDLE) continue;
+
+        read.generation = commands_handler.write_generation();
+        read.state.store(PENDING, std::memory_order_release);
+        if (!commands_handler.read_back_channel(channel, &read.value, on_read_complete, &read)) {
+            read.state.store(IDLE, std::memory_order_release);
+        }
+    }
+}
+
+void HealthMonitor::on_read_complete(const I2CResult& result, void* context) {
+    ChannelRead* read = static_cast<ChannelRead*>(context);
+    read->status = result.status;
+    read->state.store(DONE, std::memory_order_release);
+}
+
+void HealthMonitor::check_channel(uint8_t channel, uint32_t now_ms) {
+    ChannelRead& read = reads[channel - 1];
+    Sample sample = {now_ms, channel, commands_handler.desired_speed(channel), read.value, 0};
+    bool stale = read.generation != commands_handler.write_generation();
+    I2CStatus status = read.status;
+    read.state.store(IDLE, std::memory_order_release);
+
+    // A write was queued while the read was in flight; the next sample decides
+    if (stale) return;
+
+    if (status != I2CStatus::OK) {
+        sample.flags |= READ_FAILED;
+    } else if (sample.actual != sample.expected) {
+        sample.flags |= MISMATCH | REAPPLIED;
+        mismatches++;
+        commands_handler.reapply_channel(channel);
+        std::cout << "[Info] [HealthMonitor] channel " << static_cast<int>(channel)
+                  << " read " << static_cast<int>(sample.actual) << ", expected "
+                  << static_cast<int>(sample.expected) << "; re-applied" << std::endl;
+    }
+    
+    // A healthy channel only bumps a counter, so a quiet system publishes
+    // nothing but the periodic heartbeat
+    if (sample.flags == 0) {
+        ok_reads++;
+        return;
+    }
+    record(sample);
+}
+
+void HealthMonitor::record(const Sample& sample) {
+    if (sample_count == TELEMETRY_CAPACITY) {
+        // Full: overwrite the oldest sample
+        sample_head = (sample_head + 1) % TELEMETRY_CAPACITY;
+        sample_count--;
+        dropped++;
+    }
+    samples[(sample_head + sample_count) % TELEMETRY_CAPACITY] = sample;
+    sample_count++;
+}
+
+bool HealthMonitor::take_batch(const std::string& device_id, std::string& payload, bool heartbeat) {
+    if (sample_count == 0 && !heartbeat) return false;
+
+    // {"id":"gadget-01","ok":120,"s":[[time_ms,channel,expected,actual,flags],...]}
+    JsonDocument doc;
+    doc["id"] = device_id;
+    doc["ok"] = ok_reads;
+    ok_reads = 0;
+    JsonArray batch = doc["s"].to<JsonArray>();
+    for (uint8_t i = 0; i < PUBLISH_BATCH_SIZE && sample_count > 0; i++) {
+        const Sample& sample = samples[sample_head];
+        JsonArray entry = batch.add<JsonArray>();
+        entry.add(sample.time_ms);
+        entry.add(sample.channel);
+        entry.add(sample.expected);
+        entry.add(sample.actual);
+        entry.add(sample.flags);
+        sample_head = (sample_head + 1) % TELEMETRY_CAPACITY;
+        sample_count--;
+    }
+
+    payload.clear();
+    serializeJson(doc, payload);
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef HEALTH_MONITOR_H
+#define HEALTH_MONITOR_H
+
+#include <atomic>
+#include <string>
+#include "CommandsHandler.h"
+
+// Periodically reads back the motor registers through the background I2C
+// queue, re-applies any channel that does not hold the speed the current
+// CommandsHandler state calls for (desired_speed()), and keeps the flagged
+// results in a ring buffer for batched publishing. Reads that match are only
+// counted.
+class HealthMonitor {
+public:
+    enum SampleFlags : uint8_t {
+        MISMATCH = 0x01,
+        REAPPLIED = 0x02,
+        READ_FAILED = 0x04
+    };
+
+    struct Sample {
+        uint32_t time_ms;
+        uint8_t channel;
+        int8_t expected;
+        int8_t actual;
+        uint8_t flags;
+    };
+
+    static constexpr uint8_t TELEMETRY_CAPACITY = 32;
+    static constexpr uint8_t PUBLISH_BATCH_SIZE = 8;
+    static constexpr uint32_t DEFAULT_SAMPLE_INTERVAL_MS = 1000;
+
+    explicit HealthMonitor(CommandsHandler& commands_handler);
+
+    void set_sample_interval(uint32_t interval_ms) { sample_interval_ms = interval_ms; }
+
+    // Collects finished reads and starts new ones; call from the main loop
+    void poll(uint32_t now_ms);
+
+    // Moves up to PUBLISH_BATCH_SIZE of the oldest samples and the count of
+    // matching reads into a compact JSON payload, resetting that count.
+    // Returns false if no sample is buffered, unless `heartbeat` is set.
+    bool take_batch(const std::string& device_id, std::string& payload, bool heartbeat = false);
+
+    uint8_t pending_samples() const { return sample_count; }
+    uint32_t ok_read_count() const { return ok_reads; }
+    uint32_t mismatch_count() const { return mismatches; }
+    uint32_t dropped_samples() const { return dropped; }
+
+private:
+    enum ReadState : uint8_t {
+        IDLE,
+        PENDING,
+        DONE
+    };
+
+    // Written by the I2C driver task until `state` becomes DONE
+    struct ChannelRead {
+        std::atomic<uint8_t> state;
+        int8_t value;
+        I2CStatus status;
+        uint32_t generation;
+    };
+
+    CommandsHandler& commands_handler;
+    ChannelRead reads[CommandsHandler::CHANNEL_COUNT];
+    uint32_t sample_interval_ms;
+    uint32_t last_sample_ms;
+
+    Sample samples[TELEMETRY_CAPACITY];
+    uint8_t sample_head;   // Oldest sample
+    uint8_t sample_count;
+    uint32_t mismatches;
+    uint32_t dropped;
+    uint32_t ok_reads;     // Matching reads since the last payload
+
+    static void on_read_complete(const I2CResult& result, void* context);
+    void check_channel(uint8_t channel, uint32_t now_ms);
+    void record(const Sample& sample);
+};
+
+#endif // HEALTH_MONITOR_H
@@ -1,13 +1,18 @@
 #include "MQTTClient.h"
 #include "CommandsHandler.h"
+#include "CommandDispatcher.h"
+#include "HealthMonitor.h"
 #include "CredentialHandler.h"
 #include <WiFi.h>
 #include <M5Atom.h>
 #include <memory>
+#include <vector>
 
 // Global objects
 std::unique_ptr<CommandsHandler> commands_handler;
+std::unique_ptr<CommandDispatcher> command_dispatcher;
 std::unique_ptr<MQTTClient> mqtt_client;
+std::unique_ptr<HealthMonitor> health_monitor;
 Credentials credentials;
 
 // Manual mode state management
@@ -25,56 +30,40 @@ ManualMode current_manual_mode = ManualMode::STOP;
 namespace Config {
     constexpr unsigned long SERIAL_BAUD_RATE = 115200;
     constexpr unsigned long WIFI_CONNECT_DELAY = 500;
-    constexpr unsigned long MAIN_LOOP_DELAY = 100;
+    constexpr unsigned long MAIN_LOOP_DELAY = 10;
     constexpr unsigned long ERROR_HALT_DELAY = 1000;
     constexpr unsigned int MAX_WIFI_RETRIES = 5;
     constexpr const char* CREDENTIALS_FILE_PATH = "/credentials.json";
     constexpr const char* MQTT_TOPIC = "VRGadget/command";
+    constexpr const char* MQTT_TOPIC_PREFIX = "VRGadget";
+    constexpr uint32_t PELTIER_MAX_ON_MS = CommandsHandler::DEFAULT_PELTIER_MAX_ON_MS;
+    constexpr uint32_t SPLASH_MAX_ON_MS = CommandsHandler::DEFAULT_SPLASH_MAX_ON_MS;
+    constexpr uint32_t HEALTH_SAMPLE_INTERVAL_MS = HealthMonitor::DEFAULT_SAMPLE_INTERVAL_MS;
+    constexpr uint32_t HEALTH_BUS_BUDGET_US = 2000;  // Per second of read-back bus time
+    constexpr unsigned long TELEMETRY_PUBLISH_INTERVAL_MS = 10000;
+    constexpr unsigned long TELEMETRY_HEARTBEAT_INTERVAL_MS = 60000;
+    constexpr const char* TELEMETRY_TOPIC = "VRGadget/telemetry";
+    constexpr float PELTIER_HOLD_MAX_DUTY = 0.3f;
+    constexpr float PELTIER_HOLD_MAX_POWER_W = 2.0f;
 }
 
-// Command handling function - simplified version
-void call_command(const std::string& command) {
-    if (!commands_handler) {
+// MQTT callback functions
+void mqtt_command_callback(const std::string& command) {
+    if (!command_dispatcher) {
         Serial.println("[Error] Commands handler not initialized");
         return;
     }
     
-    Serial.print("[Info] Handling command: ");
-    Serial.println(command.c_str());
-    
-    if (command == "start_heating") {
-        Serial.println("[Info] Executing start_heating command");
-        commands_handler->start_heating();
-    }
-    else if (command == "finish_heating") {
-        Serial.println("[Info] Executing finish_heating command");
-        commands_handler->finish_heating();
-    }
-    else if (command == "start_cooling") {
-        Serial.println("[Info] Executing start_cooling command");
-        commands_handler->start_cooling();
-    }
-    else if (command == "finish_cooling") {
-        Serial.println("[Info] Executing finish_cooling command");
-        commands_handler->finish_cooling();
-    }
-    else if (command == "start_splash") {
-        Serial.println("[Info] Executing start_splash command");
-        commands_handler->start_splash();
-    }
-    else if (command == "finish_splash") {
-        Serial.println("[Info] Executing finish_splash command");
-        commands_handler->finish_splash();
-    }
-    else {
-        Serial.print("[Error] Unknown command: ");
-        Serial.println(command.c_str());
-    }
+    command_dispatcher->call_command(command);
 }
 
-// MQTT callback function
-void mqtt_command_callback(const std::string& command) {
-    call_command(command);
+void mqtt_batch_callback(const std::vector<std::string>& commands) {
+    if (!command_dispatcher) {
+        Serial.println("[Error] Commands handler not initialized");
+        return;
+    }
+    
+    command_dispatcher->call_batch(commands);
 }
 
 // Initialization functions
@@ -136,8 +125,21 @@ bool initialize_wifi() {
 bool initialize_mqtt() {
     Serial.println("[Info] Initializing MQTT client");
     
-    mqtt_client.reset(new MQTTClient(credentials.mqtt_token, Config::MQTT_TOPIC));
+    // Fall back to a MAC-derived id so every gadget stays individually addressable
+    if (credentials.device_id.empty()) {
+        String mac = WiFi.macAddress();
+        mac.replace(":", "");
+        credentials.device_id = std::string("gadget-") + mac.c_str();
+    }
+    Serial.print("[Info] Device ID: ");
+    Serial.println(credentials.device_id.c_str());
+    
+    mqtt_client.reset(new MQTTClient(credentials.mqtt_token, Config::MQTT_TOPIC,
+                                     credentials.mqtt_broker, credentials.mqtt_port));
+    mqtt_client->set_address(DeviceAddress(credentials.device_id, credentials.groups),
+                             Config::MQTT_TOPIC_PREFIX, credentials.addressed_topics);
     mqtt_client->subscribe(mqtt_command_callback);
+    mqtt_client->subscribe_batch(mqtt_batch_callback);
     if (mqtt_client->start()) {
         Serial.println("[Info] MQTT client initialized and started successfully");
         return true;
@@ -152,10 +154,48 @@ bool initialize_commands_handler() {
     Serial.println("[Info] Initializing commands handler");
     
     commands_handler.reset(new CommandsHandler());
+    command_dispatcher.reset(new CommandDispatcher(*commands_handler));
+    commands_handler->set_max_on_time(CommandsHandler::PELTIER_CHANNEL, Config::PELTIER_MAX_ON_MS);
+    commands_handler->set_max_on_time(CommandsHandler::SPLASH_CHANNEL, Config::SPLASH_MAX_ON_MS);
+    commands_handler->set_readback_budget(Config::HEALTH_BUS_BUDGET_US);
+    
+    PeltierModelParams thermal_params;
+    thermal_params.max_hold_duty = Config::PELTIER_HOLD_MAX_DUTY;
+    thermal_params.max_hold_power_w = Config::PELTIER_HOLD_MAX_POWER_W;
+    commands_handler->set_thermal_model(thermal_params);
     Serial.println("[Info] Commands handler initialized successfully");
     return true;
 }
 
+bool initialize_health_monitor() {
+    Serial.println("[Info] Initializing health monitor");
+    
+    health_monitor.reset(new HealthMonitor(*commands_handler));
+    health_monitor->set_sample_interval(Config::HEALTH_SAMPLE_INTERVAL_MS);
+    Serial.println("[Info] Health monitor initialized successfully");
+    return true;
+}
+
+// Publishes telemetry once a full batch is buffered, periodically if less,
+// and as a heartbeat with only the OK-read count when nothing was flagged
+void publish_telemetry(unsigned long now_ms) {
+    static unsigned long last_publish_ms = 0;
+    
+    if (!health_monitor || !mqtt_client || !mqtt_client->isConnected()) return;
+    uint8_t pending = health_monitor->pending_samples();
+    bool heartbeat = now_ms - last_publish_ms >= Config::TELEMETRY_HEARTBEAT_INTERVAL_MS;
+    if (pending < HealthMonitor::PUBLISH_BATCH_SIZE && !heartbeat &&
+        (pending == 0 || now_ms - last_publish_ms < Config::TELEMETRY_PUBLISH_INTERVAL_MS)) {
+        return;
+    }
+    
+    std::string payload;
+    if (health_monitor->take_batch(credentials.device_id, payload, heartbeat)) {
+        mqtt_client->publish(Config::TELEMETRY_TOPIC, payload);
+        last_publish_ms = now_ms;
+    }
+}
+
 void handle_fatal_error(const char* error_message) {
     Serial.println(error_message);
     // Serial.println("[Fatal] System cannot continue. Entering infinite loop.");
@@ -184,6 +224,7 @@ void apply_manual_mode() {
         return;
     }
     
+    commands_handler->begin_batch();
     switch (current_manual_mode) {
         case ManualMode::STOP:
             Serial.println("[Info] Manual mode: Stopping all operations");
@@ -213,6 +254,7 @@ void apply_manual_mode() {
             commands_handler->finish_cooling();
             break;
     }
+    commands_handler->commit_batch();
 }
 
 void handle_button_press() {
@@ -250,6 +292,11 @@ void setup() {
         handle_fatal_error("[Fatal] Failed to initialize commands handler");
     }
     
+    // Initialize actuator read-back verification
+    if (!initialize_health_monitor()) {
+        handle_fatal_error("[Fatal] Failed to initialize health monitor");
+    }
+    
     Serial.println("[Info] ========================================");
     Serial.println("[Info] VRGadget setup completed successfully");
     Serial.println("[Info] System ready to receive commands");
@@ -273,6 +320,17 @@ void loop() {
         handle_button_press();
     }
     
+    // Switch off effects whose duration or max on-time has elapsed
+    if (commands_handler) {
+        commands_handler->tick(millis());
+    }
+    
+    // Verify actuator state in the background and publish the results
+    if (health_monitor) {
+        health_monitor->poll(millis());
+        publish_telemetry(millis());
+    }
+    
     // Small delay to prevent excessive CPU usage
     delay(Config::MAIN_LOOP_DELAY);
 }
@@ -0,0 +1,109 @@
+#ifndef NATIVE_STUB_ATOM_MOTION_H
+#define NATIVE_STUB_ATOM_MOTION_H
+
+// Host stand-in for AtomMotion: records the motor writes instead of queueing
+// I2C transactions and keeps the motor registers in `speeds`. The state is
+// static because CommandsHandler owns its AtomMotion privately.
+
+#include <cstdint>
+#include <vector>
+
+enum class I2CStatus : uint8_t {
+    OK = 0,
+    DATA_TOO_LONG = 1,
+    ADDRESS_NACK = 2,
+    DATA_NACK = 3,
+    BUS_ERROR = 4,
+    TIMEOUT = 5,
+    SHORT_READ = 6,
+    QUEUE_FULL = 7,
+    NOT_STARTED = 8
+};
+
+struct I2CResult {
+    uint32_t id;
+    I2CStatus status;
+    uint8_t attempts;
+    uint32_t bus_time_us;
+};
+
+using I2CCompletion = void (*)(const I2CResult& result, void* context);
+
+struct I2CBusStats {
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t retries;
+    uint32_t dropped;
+    uint64_t bus_time_us;
+    I2CStatus last_status;
+};
+
+struct MotorWrite {
+    uint8_t channel;
+    int8_t speed;
+};
+
+struct PendingRead {
+    uint8_t channel;
+    int8_t* dest;
+    I2CCompletion on_complete;
+    void* context;
+};
+
+class AtomMotion {
+   public:
+    static inline std::vector<MotorWrite> writes;
+    static inline bool queue_full = false;
+    static inline I2CStatus write_status = I2CStatus::OK;  // Reported to completions
+    static inline int8_t speeds[2] = {0, 0};               // Motor registers
+    static inline std::vector<PendingRead> reads;          // Queued read-backs
+    static inline I2CStatus read_status = I2CStatus::OK;
+
+    static void reset() {
+        writes.clear();
+        queue_full = false;
+        write_status = I2CStatus::OK;
+        speeds[0] = speeds[1] = 0;
+        reads.clear();
+        read_status = I2CStatus::OK;
+    }
+
+    // Runs the queued read-backs, as the driver task would
+    static void complete_reads() {
+        std::vector<PendingRead> queued;
+        queued.swap(reads);
+        for (const PendingRead& read : queued) {
+            if (read_status == I2CStatus::OK) *read.dest = speeds[read.channel - 1];
+            read.on_complete(I2CResult{0, read_status, 1, 0}, read.context);
+        }
+    }
+
+    bool Init(uint32_t = 400000) { return true; }
+    uint32_t GetBusFrequency() const { return 400000; }
+    I2CBusStats GetBusStats() const { return I2CBusStats{}; }
+    void SetBackgroundBudget(uint32_t) {}
+
+    // Completes immediately, as if the driver task had run the write
+    uint8_t SetMotorSpeed(uint8_t Motor_CH, int8_t speed,
+                          I2CCompletion on_complete = nullptr, void* context = nullptr) {
+        if (queue_full) return 2;
+        writes.push_back({Motor_CH, speed});
+        if (write_status == I2CStatus::OK) speeds[Motor_CH - 1] = speed;
+        if (on_complete != nullptr) {
+            on_complete(I2CResult{static_cast<uint32_t>(writes.size()), write_status, 1, 0}, context);
+        }
+        return 0;
+    }
+
+    // Stays queued until complete_reads()
+    uint8_t ReadMotorSpeedAsync(uint8_t Motor_CH, int8_t* dest, I2CCompletion on_complete,
+                                void* context) {
+        if (Motor_CH < 1 || Motor_CH > 2) return 1;
+        if (queue_full) return 2;
+        reads.push_back({Motor_CH, dest, on_complete, context});
+        return 0;
+    }
+};
+
+#endif // NATIVE_STUB_ATOM_MOTION_H
@@ -0,0 +1,30 @@
+#ifndef NATIVE_STUB_M5ATOM_H
+#define NATIVE_STUB_M5ATOM_H
+
+// Host stand-in for the parts of M5Atom/Arduino used by CommandsHandler
+
+#include <cstdint>
+
+// Tests move time forward explicitly
+inline uint32_t fake_millis = 0;
+
+inline uint32_t millis() {
+    return fake_millis;
+}
+
+struct FakeDisplay {
+    uint32_t updates = 0;
+    uint32_t color = 0;
+    void drawpix(uint8_t, uint32_t value) {
+        color = value;
+        updates++;
+    }
+};
+
+struct FakeM5 {
+    FakeDisplay dis;
+};
+
+inline FakeM5 M5;
+
+#endif // NATIVE_STUB_M5ATOM_H
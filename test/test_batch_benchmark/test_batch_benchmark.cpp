@@ -0,0 +1,123 @@
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CommandDispatcher.h"
+
+// Compares a scene change sent as one MQTT message per command against the
+// same change sent as one batch. Runs against test/native_stubs, so the
+// numbers cover command parsing and state handling, not the I2C bus.
+static const std::vector<std::string> TO_COOLING = {"finish_heating", "start_cooling", "start_splash"};
+static const std::vector<std::string> TO_HEATING = {"finish_cooling", "finish_splash", "start_heating"};
+static const int EFFECT_COUNT = 20000;
+static const int ROUNDS = 5;  // The fastest round is reported
+
+struct RunResult {
+    double us_per_effect;
+    uint32_t motor_writes;
+    uint32_t led_updates;
+    bool peltier_stopped;  // Whether the Peltier was ever written to STOP
+};
+
+// Logging is muted while measuring; it would otherwise dominate the timings
+class MutedLog {
+public:
+    MutedLog() : previous(std::cout.rdbuf(sink.rdbuf())) {}
+    ~MutedLog() { std::cout.rdbuf(previous); }
+
+private:
+    std::ostringstream sink;
+    std::streambuf* previous;
+};
+
+static RunResult run_effects(bool batched) {
+    MutedLog muted;
+    CommandsHandler handler;
+    CommandDispatcher dispatcher(handler);
+    dispatcher.call_command("start_heating");  // Every effect starts from a running scene
+    AtomMotion::writes.clear();
+    AtomMotion::writes.reserve(EFFECT_COUNT * 6);
+    uint32_t led_updates_before = M5.dis.updates;
+
+    RunResult result;
+    result.us_per_effect = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        AtomMotion::writes.clear();
+        led_updates_before = M5.dis.updates;
+        auto started = std::chrono::steady_clock::now();
+        for (int effect = 0; effect < EFFECT_COUNT; effect++) {
+            const std::vector<std::string>& commands = effect % 2 == 0 ? TO_COOLING : TO_HEATING;
+            if (batched) {
+                dispatcher.call_batch(commands);
+            } else {
+                for (const std::string& command : commands) {
+                    dispatcher.call_command(command);
+                }
+            }
+        }
+        auto elapsed = std::chrono::steady_clock::now() - started;
+        double us_per_effect = std::chrono::duration<double, std::micro>(elapsed).count() / EFFECT_COUNT;
+        if (round == 0 || us_per_effect < result.us_per_effect) result.us_per_effect = us_per_effect;
+    }
+
+    result.motor_writes = AtomMotion::writes.size();
+    result.led_updates = M5.dis.updates - led_updates_before;
+    result.peltier_stopped = false;
+    for (const MotorWrite& write : AtomMotion::writes) {
+        if (write.channel == CommandsHandler::PELTIER_CHANNEL && write.speed == CommandsHandler::STOP_VALUE) {
+            result.peltier_stopped = true;
+        }
+    }
+    return result;
+}
+
+static void report(const char* label, size_t messages, const RunResult& result) {
+    char line[160];
+    snprintf(line, sizeof(line),
+             "%s: %zu messages, %.1f motor writes, %.1f LED updates, %.2f us per effect",
+             label, messages, static_cast<double>(result.motor_writes) / EFFECT_COUNT,
+             static_cast<double>(result.led_updates) / EFFECT_COUNT,
+             result.us_per_effect);
+    TEST_MESSAGE(line);
+}
+
+void setUp() {
+    AtomMotion::reset();
+}
+void tearDown() {}
+
+void test_batch_writes_only_the_final_state() {
+    RunResult single = run_effects(false);
+    RunResult batch = run_effects(true);
+    report("call_command x3", TO_COOLING.size(), single);
+    report("call_batch", 1, batch);
+
+    // Separate commands pass through "Peltier off" between heating and cooling
+    TEST_ASSERT_TRUE(single.peltier_stopped);
+    TEST_ASSERT_FALSE(batch.peltier_stopped);
+    TEST_ASSERT_EQUAL_UINT32(3 * EFFECT_COUNT, single.motor_writes);
+    TEST_ASSERT_EQUAL_UINT32(2 * EFFECT_COUNT, batch.motor_writes);
+    TEST_ASSERT_EQUAL_UINT32(3 * EFFECT_COUNT, single.led_updates);
+    TEST_ASSERT_EQUAL_UINT32(1 * EFFECT_COUNT, batch.led_updates);
+}
+
+void test_invalid_batch_changes_nothing() {
+    MutedLog muted;
+    CommandsHandler handler;
+    CommandDispatcher dispatcher(handler);
+    AtomMotion::writes.clear();
+
+    TEST_ASSERT_FALSE(dispatcher.call_batch({"start_heating", "start_splash for=0ms"}));
+    TEST_ASSERT_FALSE(handler.is_heating_active());
+    TEST_ASSERT_EQUAL(0u, AtomMotion::writes.size());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_batch_writes_only_the_final_state);
+    RUN_TEST(test_invalid_batch_changes_nothing);
+    return UNITY_END();
+}
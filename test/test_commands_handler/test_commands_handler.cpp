@@ -0,0 +1,147 @@
+#include <unity.h>
+#include <iostream>
+#include <sstream>
+#include "CommandDispatcher.h"
+
+// Drives CommandsHandler and CommandDispatcher through tick() with the fake
+// clock and AtomMotion from test/native_stubs
+static std::ostringstream log_sink;
+static std::streambuf* saved_log = nullptr;
+
+// Runs the main loop until `until_ms` on the fake clock
+static void run_until(CommandsHandler& handler, uint32_t until_ms) {
+    while (fake_millis < until_ms) {
+        fake_millis += CommandsHandler::TIMER_TICK_MS;
+        handler.tick(fake_millis);
+    }
+}
+
+// Callers check the write count first
+static const MotorWrite& last_write() {
+    return AtomMotion::writes.back();
+}
+
+void setUp() {
+    saved_log = std::cout.rdbuf(log_sink.rdbuf());
+    fake_millis = 0;
+    AtomMotion::reset();
+}
+
+void tearDown() {
+    std::cout.rdbuf(saved_log);
+    log_sink.str("");
+}
+
+void test_nacked_write_is_retried() {
+    CommandsHandler handler;
+    handler.start_heating();
+
+    // finish_heating is queued, but the bus NACKs it
+    AtomMotion::write_status = I2CStatus::DATA_NACK;
+    handler.finish_heating();
+    TEST_ASSERT_EQUAL(2u, AtomMotion::writes.size());
+
+    // Still failing: every tick tries again
+    handler.tick(fake_millis += 10);
+    TEST_ASSERT_EQUAL(3u, AtomMotion::writes.size());
+
+    AtomMotion::write_status = I2CStatus::OK;
+    handler.tick(fake_millis += 10);
+    TEST_ASSERT_EQUAL(4u, AtomMotion::writes.size());
+    TEST_ASSERT_EQUAL(CommandsHandler::PELTIER_CHANNEL, last_write().channel);
+    TEST_ASSERT_EQUAL_INT8(CommandsHandler::STOP_VALUE, last_write().speed);
+
+    // Once the write went through nothing is sent again
+    handler.tick(fake_millis += 10);
+    TEST_ASSERT_EQUAL(4u, AtomMotion::writes.size());
+}
+
+void test_unqueued_write_is_retried() {
+    CommandsHandler handler;
+    AtomMotion::queue_full = true;
+    handler.start_splash();
+    TEST_ASSERT_EQUAL(0u, AtomMotion::writes.size());
+
+    AtomMotion::queue_full = false;
+    handler.tick(fake_millis += 10);
+    TEST_ASSERT_EQUAL(1u, AtomMotion::writes.size());
+    TEST_ASSERT_EQUAL(CommandsHandler::SPLASH_CHANNEL, last_write().channel);
+    TEST_ASSERT_EQUAL_INT8(CommandsHandler::SPLASH_VALUE, last_write().speed);
+}
+
+void test_timed_command_switches_off() {
+    CommandsHandler handler;
+    CommandDispatcher dispatcher(handler);
+    TEST_ASSERT_TRUE(dispatcher.call_command("start_heating for=800ms"));
+    TEST_ASSERT_EQUAL_INT8(CommandsHandler::HEATING_VALUE, last_write().speed);
+
+    run_until(handler, 790);
+    TEST_ASSERT_TRUE(handler.is_heating_active());
+    run_until(handler, 800);
+    TEST_ASSERT_FALSE(handler.is_heating_active());
+    TEST_ASSERT_EQUAL_INT8(CommandsHandler::STOP_VALUE, last_write().speed);
+}
+
+void test_max_on_time_caps_untimed_start() {
+    CommandsHandler handler;
+    handler.set_max_on_time(CommandsHandler::PELTIER_CHANNEL, 1000);
+    handler.start_cooling();
+
+    run_until(handler, 990);
+    TEST_ASSERT_TRUE(handler.is_cooling_active());
+    run_until(handler, 1000);
+    TEST_ASSERT_FALSE(handler.is_cooling_active());
+    TEST_ASSERT_EQUAL_INT8(CommandsHandler::STOP_VALUE, last_write().speed);
+}
+
+void test_max_on_time_caps_longer_duration() {
+    CommandsHandler handler;
+    handler.set_max_on_time(CommandsHandler::SPLASH_CHANNEL, 500);
+    handler.start_splash(2000);
+
+    run_until(handler, 500);
+    TEST_ASSERT_FALSE(handler.is_splash_active());
+}
+
+void test_max_on_time_caps_prepare() {
+    CommandsHandler handler;
+    handler.set_max_on_time(CommandsHandler::PELTIER_CHANNEL, 1000);
+    handler.prepare_heating();
+    TEST_ASSERT_TRUE(handler.is_preparing());
+    TEST_ASSERT_TRUE(last_write().speed < CommandsHandler::STOP_VALUE);
+
+    run_until(handler, 990);
+    TEST_ASSERT_TRUE(handler.is_preparing());
+    run_until(handler, 1000);
+    TEST_ASSERT_FALSE(handler.is_preparing());
+    TEST_ASSERT_EQUAL_INT8(CommandsHandler::STOP_VALUE, last_write().speed);
+}
+
+void test_invalid_durations_are_rejected() {
+    CommandsHandler handler;
+    CommandDispatcher dispatcher(handler);
+
+    TEST_ASSERT_FALSE(dispatcher.call_command("start_heating for=0"));
+    TEST_ASSERT_FALSE(dispatcher.call_command("start_heating for=0ms"));
+    TEST_ASSERT_FALSE(dispatcher.call_command("start_cooling for=3601s"));
+    TEST_ASSERT_FALSE(dispatcher.call_command("start_splash for=3600001ms"));
+    TEST_ASSERT_FALSE(dispatcher.call_command("start_splash for=99999999999ms"));
+    TEST_ASSERT_FALSE(dispatcher.call_command("finish_heating for=1s"));
+    TEST_ASSERT_FALSE(dispatcher.call_command("prepare_cooling for=2m"));
+    TEST_ASSERT_EQUAL(0u, AtomMotion::writes.size());
+
+    TEST_ASSERT_TRUE(dispatcher.call_command("start_splash for=3600s"));
+    TEST_ASSERT_TRUE(dispatcher.call_command("finish_splash"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_nacked_write_is_retried);
+    RUN_TEST(test_unqueued_write_is_retried);
+    RUN_TEST(test_timed_command_switches_off);
+    RUN_TEST(test_max_on_time_caps_untimed_start);
+    RUN_TEST(test_max_on_time_caps_longer_duration);
+    RUN_TEST(test_max_on_time_caps_prepare);
+    RUN_TEST(test_invalid_durations_are_rejected);
+    return UNITY_END();
+}
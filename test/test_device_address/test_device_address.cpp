@@ -0,0 +1,143 @@
+#include <unity.h>
+#include <string>
+#include <vector>
+#include "DeviceAddress.h"
+
+// A play space with several gadgets; each publish below is delivered once
+// and every gadget decides on its own whether it is addressed.
+static const std::string PREFIX = "VRGadget";
+
+static std::vector<DeviceAddress> make_fleet() {
+    return {
+        DeviceAddress("gadget-01", {"stage-a"}),
+        DeviceAddress("gadget-02", {"stage-a", "lobby"}),
+        DeviceAddress("gadget-03", {"stage-b"}),
+        DeviceAddress("gadget-04", {"lobby"}),
+        DeviceAddress("gadget-05", {}),
+    };
+}
+
+// Returns the ids of the gadgets that accept `topic`, e.g. "gadget-01,gadget-02"
+static std::string topic_receivers(const std::vector<DeviceAddress>& fleet, const char* topic) {
+    std::string receivers;
+    for (const DeviceAddress& device : fleet) {
+        if (device.matches_topic(topic, PREFIX)) {
+            receivers += receivers.empty() ? "" : ",";
+            receivers += device.device_id();
+        }
+    }
+    TEST_MESSAGE((std::string(topic) + " -> " + receivers).c_str());
+    return receivers;
+}
+
+// Returns the ids of the gadgets a JSON command payload is addressed to
+static std::string payload_receivers(const std::vector<DeviceAddress>& fleet, const char* payload) {
+    JsonDocument doc;
+    deserializeJson(doc, payload);
+    std::string receivers;
+    for (const DeviceAddress& device : fleet) {
+        if (device.matches_payload(doc.as<JsonVariantConst>())) {
+            receivers += receivers.empty() ? "" : ",";
+            receivers += device.device_id();
+        }
+    }
+    TEST_MESSAGE((std::string(payload) + " -> " + receivers).c_str());
+    return receivers;
+}
+
+static std::string target_receivers(const std::vector<DeviceAddress>& fleet, const char* target) {
+    std::string receivers;
+    for (const DeviceAddress& device : fleet) {
+        if (device.matches_target(target)) {
+            receivers += receivers.empty() ? "" : ",";
+            receivers += device.device_id();
+        }
+    }
+    TEST_MESSAGE((std::string("to=") + target + " -> " + receivers).c_str());
+    return receivers;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_legacy_topic_reaches_every_gadget() {
+    TEST_ASSERT_EQUAL_STRING("gadget-01,gadget-02,gadget-03,gadget-04,gadget-05",
+                             topic_receivers(make_fleet(), "VRGadget/command").c_str());
+}
+
+void test_group_topic_reaches_only_group_members() {
+    std::vector<DeviceAddress> fleet = make_fleet();
+    TEST_ASSERT_EQUAL_STRING("gadget-01,gadget-02",
+                             topic_receivers(fleet, "VRGadget/stage-a/*/command").c_str());
+    TEST_ASSERT_EQUAL_STRING("gadget-02,gadget-04",
+                             topic_receivers(fleet, "VRGadget/lobby/*/command").c_str());
+}
+
+void test_device_topic_reaches_one_gadget() {
+    std::vector<DeviceAddress> fleet = make_fleet();
+    TEST_ASSERT_EQUAL_STRING("gadget-03",
+                             topic_receivers(fleet, "VRGadget/*/gadget-03/command").c_str());
+    TEST_ASSERT_EQUAL_STRING("", topic_receivers(fleet, "VRGadget/lobby/gadget-03/command").c_str());
+}
+
+void test_payload_targets() {
+    std::vector<DeviceAddress> fleet = make_fleet();
+    TEST_ASSERT_EQUAL_STRING("gadget-01,gadget-02,gadget-03,gadget-04,gadget-05",
+                             target_receivers(fleet, "*").c_str());
+    TEST_ASSERT_EQUAL_STRING("gadget-03", target_receivers(fleet, "stage-b/*").c_str());
+    TEST_ASSERT_EQUAL_STRING("gadget-05", target_receivers(fleet, "gadget-05").c_str());
+    TEST_ASSERT_EQUAL_STRING("gadget-04", target_receivers(fleet, "*/gadget-04").c_str());
+    TEST_ASSERT_EQUAL_STRING("", target_receivers(fleet, "gadget-0").c_str());
+}
+
+void test_payload_without_to_reaches_every_gadget() {
+    std::vector<DeviceAddress> fleet = make_fleet();
+    const char* everyone = "gadget-01,gadget-02,gadget-03,gadget-04,gadget-05";
+    TEST_ASSERT_EQUAL_STRING(everyone, payload_receivers(fleet, "{\"data\":\"start_heating\"}").c_str());
+    TEST_ASSERT_EQUAL_STRING(everyone, payload_receivers(fleet, "{\"data\":\"start_heating\",\"to\":null}").c_str());
+}
+
+void test_payload_to_string() {
+    std::vector<DeviceAddress> fleet = make_fleet();
+    TEST_ASSERT_EQUAL_STRING("gadget-01,gadget-02", payload_receivers(fleet, "{\"to\":\"stage-a/*\"}").c_str());
+    TEST_ASSERT_EQUAL_STRING("gadget-05", payload_receivers(fleet, "{\"to\":\"gadget-05\"}").c_str());
+    TEST_ASSERT_EQUAL_STRING("", payload_receivers(fleet, "{\"to\":\"\"}").c_str());
+}
+
+void test_payload_to_array() {
+    std::vector<DeviceAddress> fleet = make_fleet();
+    TEST_ASSERT_EQUAL_STRING("gadget-02,gadget-03,gadget-04",
+                             payload_receivers(fleet, "{\"to\":[\"gadget-03\",\"lobby/*\"]}").c_str());
+    TEST_ASSERT_EQUAL_STRING("", payload_receivers(fleet, "{\"to\":[]}").c_str());
+}
+
+void test_payload_to_ignores_non_strings() {
+    std::vector<DeviceAddress> fleet = make_fleet();
+    TEST_ASSERT_EQUAL_STRING("gadget-05",
+                             payload_receivers(fleet, "{\"to\":[1,null,{\"id\":\"gadget-01\"},[\"gadget-02\"],\"gadget-05\"]}").c_str());
+    TEST_ASSERT_EQUAL_STRING("", payload_receivers(fleet, "{\"to\":[42]}").c_str());
+    TEST_ASSERT_EQUAL_STRING("", payload_receivers(fleet, "{\"to\":42}").c_str());
+    TEST_ASSERT_EQUAL_STRING("", payload_receivers(fleet, "{\"to\":{\"group\":\"*\"}}").c_str());
+}
+
+void test_subscriptions_cover_groups() {
+    std::vector<std::string> topics = DeviceAddress("gadget-02", {"stage-a", "lobby"}).subscription_topics(PREFIX);
+    TEST_ASSERT_EQUAL(3u, topics.size());
+    TEST_ASSERT_EQUAL_STRING("VRGadget/*/+/command", topics[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("VRGadget/stage-a/+/command", topics[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("VRGadget/lobby/+/command", topics[2].c_str());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_legacy_topic_reaches_every_gadget);
+    RUN_TEST(test_group_topic_reaches_only_group_members);
+    RUN_TEST(test_device_topic_reaches_one_gadget);
+    RUN_TEST(test_payload_targets);
+    RUN_TEST(test_payload_without_to_reaches_every_gadget);
+    RUN_TEST(test_payload_to_string);
+    RUN_TEST(test_payload_to_array);
+    RUN_TEST(test_payload_to_ignores_non_strings);
+    RUN_TEST(test_subscriptions_cover_groups);
+    return UNITY_END();
+}
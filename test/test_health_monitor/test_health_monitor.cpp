@@ -0,0 +1,144 @@
+#include <unity.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "HealthMonitor.h"
+
+// Read-backs are queued on the fake AtomMotion and complete only when the
+// test calls AtomMotion::complete_reads(), so writes can land in between
+static const uint32_t INTERVAL_MS = HealthMonitor::DEFAULT_SAMPLE_INTERVAL_MS;
+
+static std::ostringstream log_sink;
+static std::streambuf* saved_log = nullptr;
+
+// Starts a read of every channel at `now_ms`, lets the bus answer and
+// collects the results one loop later
+static void sample_once(HealthMonitor& monitor, uint32_t now_ms) {
+    monitor.poll(now_ms);
+    AtomMotion::complete_reads();
+    monitor.poll(now_ms + 10);
+}
+
+// Takes one batch, heartbeat included; empty if nothing was produced
+static std::string take_all(HealthMonitor& monitor) {
+    std::string payload;
+    monitor.take_batch("gadget-01", payload, true);
+    TEST_MESSAGE(payload.c_str());
+    return payload;
+}
+
+void setUp() {
+    saved_log = std::cout.rdbuf(log_sink.rdbuf());
+    fake_millis = 0;
+    AtomMotion::reset();
+}
+
+void tearDown() {
+    std::cout.rdbuf(saved_log);
+    log_sink.str("");
+}
+
+void test_matching_reads_are_only_counted() {
+    CommandsHandler handler;
+    HealthMonitor monitor(handler);
+    handler.start_heating();
+
+    sample_once(monitor, INTERVAL_MS);
+    sample_once(monitor, 2 * INTERVAL_MS);
+    TEST_ASSERT_EQUAL(0, monitor.pending_samples());
+    TEST_ASSERT_EQUAL_UINT32(4, monitor.ok_read_count());
+
+    std::string payload;
+    TEST_ASSERT_FALSE(monitor.take_batch("gadget-01", payload));
+    TEST_ASSERT_EQUAL_STRING("{\"id\":\"gadget-01\",\"ok\":4,\"s\":[]}", take_all(monitor).c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, monitor.ok_read_count());
+}
+
+void test_mismatch_is_reapplied() {
+    CommandsHandler handler;
+    HealthMonitor monitor(handler);
+    handler.start_heating();
+    AtomMotion::speeds[0] = CommandsHandler::STOP_VALUE;  // The board lost the write
+    size_t writes_before = AtomMotion::writes.size();
+
+    sample_once(monitor, INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT32(1, monitor.mismatch_count());
+    TEST_ASSERT_EQUAL(writes_before + 1, AtomMotion::writes.size());
+    TEST_ASSERT_EQUAL(CommandsHandler::PELTIER_CHANNEL, AtomMotion::writes.back().channel);
+    TEST_ASSERT_EQUAL_INT8(CommandsHandler::HEATING_VALUE, AtomMotion::speeds[0]);
+
+    // Flags: MISMATCH | REAPPLIED. The re-apply is a write, so the splash
+    // read from the same round is discarded rather than counted.
+    TEST_ASSERT_EQUAL_STRING("{\"id\":\"gadget-01\",\"ok\":0,\"s\":[[1010,1,-127,0,3]]}",
+                             take_all(monitor).c_str());
+}
+
+void test_read_overlapping_a_write_is_discarded() {
+    CommandsHandler handler;
+    HealthMonitor monitor(handler);
+
+    monitor.poll(INTERVAL_MS);
+    handler.start_splash();  // Queued while the reads are in flight
+    AtomMotion::complete_reads();
+    monitor.poll(INTERVAL_MS + 10);
+
+    TEST_ASSERT_EQUAL(0, monitor.pending_samples());
+    TEST_ASSERT_EQUAL_UINT32(0, monitor.ok_read_count());
+    TEST_ASSERT_EQUAL_UINT32(0, monitor.mismatch_count());
+    TEST_ASSERT_EQUAL(1u, AtomMotion::writes.size());
+
+    // The next round sees the new state
+    sample_once(monitor, 2 * INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT32(2, monitor.ok_read_count());
+}
+
+void test_failed_read_is_not_reapplied() {
+    CommandsHandler handler;
+    HealthMonitor monitor(handler);
+    handler.start_cooling();
+    AtomMotion::speeds[0] = CommandsHandler::STOP_VALUE;
+    AtomMotion::read_status = I2CStatus::TIMEOUT;
+    size_t writes_before = AtomMotion::writes.size();
+
+    sample_once(monitor, INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT32(0, monitor.mismatch_count());
+    TEST_ASSERT_EQUAL(writes_before, AtomMotion::writes.size());
+    TEST_ASSERT_EQUAL(2, monitor.pending_samples());
+
+    std::string payload = take_all(monitor);
+    TEST_ASSERT_TRUE(payload.find("[1010,1,127,0,4]") != std::string::npos);
+    TEST_ASSERT_TRUE(payload.find("[1010,2,0,0,4]") != std::string::npos);
+}
+
+void test_full_buffer_drops_oldest() {
+    CommandsHandler handler;
+    HealthMonitor monitor(handler);
+    AtomMotion::read_status = I2CStatus::TIMEOUT;
+
+    // Two failed reads per round: 40 rounds overflow the buffer by 48
+    const uint32_t rounds = 40;
+    for (uint32_t round = 1; round <= rounds; round++) {
+        sample_once(monitor, round * INTERVAL_MS);
+    }
+    const uint32_t recorded = 2 * rounds;
+    TEST_ASSERT_EQUAL(HealthMonitor::TELEMETRY_CAPACITY, monitor.pending_samples());
+    TEST_ASSERT_EQUAL_UINT32(recorded - HealthMonitor::TELEMETRY_CAPACITY, monitor.dropped_samples());
+
+    // The oldest kept sample is from the first round that was not dropped
+    uint32_t first_kept_round = rounds - HealthMonitor::TELEMETRY_CAPACITY / 2 + 1;
+    std::string oldest = "[[" + std::to_string(first_kept_round * INTERVAL_MS + 10) + ",1,";
+    std::string payload = take_all(monitor);
+    TEST_ASSERT_TRUE(payload.find(oldest) != std::string::npos);
+    TEST_ASSERT_EQUAL(HealthMonitor::TELEMETRY_CAPACITY - HealthMonitor::PUBLISH_BATCH_SIZE,
+                      monitor.pending_samples());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_matching_reads_are_only_counted);
+    RUN_TEST(test_mismatch_is_reapplied);
+    RUN_TEST(test_read_overlapping_a_write_is_discarded);
+    RUN_TEST(test_failed_read_is_not_reapplied);
+    RUN_TEST(test_full_buffer_drops_oldest);
+    return UNITY_END();
+}
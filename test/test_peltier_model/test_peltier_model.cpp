@@ -0,0 +1,64 @@
+#include <unity.h>
+#include "PeltierModel.h"
+
+// Default parameters: gain 15 C, tau 10 s, perceptible at 3 C and a holding
+// target of 0.6 * 3 C, i.e. a 0.12 holding duty
+void setUp() {}
+void tearDown() {}
+
+void test_onset_from_ambient() {
+    PeltierModel model;
+    // tau * ln(15 / (15 - 3))
+    TEST_ASSERT_UINT32_WITHIN(2, 2232, model.onset_latency_ms(1));
+    TEST_ASSERT_UINT32_WITHIN(2, 2232, model.onset_latency_ms(-1));
+}
+
+void test_onset_after_holding() {
+    PeltierModelParams params;
+    PeltierModel::SimulationResult cold = PeltierModel::simulate(params, 0, 1);
+    PeltierModel::SimulationResult held = PeltierModel::simulate(params, 10000, 1);
+
+    TEST_ASSERT_UINT32_WITHIN(2, 2232, cold.onset_latency_ms);
+    TEST_ASSERT_UINT32_WITHIN(5, 1443, held.onset_latency_ms);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 12.0f, held.hold_energy_j);
+}
+
+void test_holding_duty_respects_duty_limit() {
+    PeltierModelParams params;
+    params.max_hold_duty = 0.05f;
+    PeltierModel model(params);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.05f, model.holding_duty());
+}
+
+void test_holding_duty_respects_power_limit() {
+    PeltierModelParams params;
+    params.max_hold_power_w = 0.5f;
+    PeltierModel model(params);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.05f, model.holding_duty());
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, model.holding_power_w());
+}
+
+void test_holding_duty_below_limits() {
+    PeltierModel model;
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.12f, model.holding_duty());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.2f, model.holding_power_w());
+}
+
+void test_onset_unreachable_without_enough_gain() {
+    PeltierModelParams params;
+    params.gain_c = 3.0f;
+    TEST_ASSERT_EQUAL_UINT32(PeltierModel::UNREACHABLE_MS, PeltierModel(params).onset_latency_ms(1));
+    params.gain_c = 2.0f;
+    TEST_ASSERT_EQUAL_UINT32(PeltierModel::UNREACHABLE_MS, PeltierModel(params).onset_latency_ms(-1));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_onset_from_ambient);
+    RUN_TEST(test_onset_after_holding);
+    RUN_TEST(test_holding_duty_respects_duty_limit);
+    RUN_TEST(test_holding_duty_respects_power_limit);
+    RUN_TEST(test_holding_duty_below_limits);
+    RUN_TEST(test_onset_unreachable_without_enough_gain);
+    return UNITY_END();
+}
@@ -0,0 +1,138 @@
+#include <unity.h>
+#include "TimerWheel.h"
+
+static const uint32_t TICK_MS = 10;
+static const uint32_t NOT_FIRED = UINT32_MAX;
+
+// Remembers when (on the caller's clock) a timer fired and with which arg
+struct Probe {
+    uint32_t now_ms = 0;
+    uint32_t fired_at_ms = NOT_FIRED;
+    uint32_t fired_arg = 0;
+    uint32_t fire_count = 0;
+};
+
+static void on_fire(void* context, uint32_t arg) {
+    Probe* probe = static_cast<Probe*>(context);
+    probe->fired_at_ms = probe->now_ms;
+    probe->fired_arg = arg;
+    probe->fire_count++;
+}
+
+// Advances in `step_ms` increments until the timer fires or `span_ms` passes
+static void run_for(TimerWheel& wheel, Probe& probe, uint32_t span_ms, uint32_t step_ms) {
+    uint32_t start_ms = probe.now_ms;
+    while (probe.fire_count == 0 && probe.now_ms - start_ms < span_ms) {
+        probe.now_ms += step_ms;
+        wheel.advance(probe.now_ms);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_rounds_up_to_whole_ticks() {
+    Probe probe;
+    TimerWheel wheel(TICK_MS, 0);
+    wheel.schedule(0, 25, on_fire, &probe, 7);
+
+    wheel.advance(29);
+    TEST_ASSERT_EQUAL_UINT32(0, probe.fire_count);
+    probe.now_ms = 30;
+    wheel.advance(30);
+    TEST_ASSERT_EQUAL_UINT32(1, probe.fire_count);
+    TEST_ASSERT_EQUAL_UINT32(7, probe.fired_arg);
+    TEST_ASSERT_EQUAL(0u, wheel.active_count());
+}
+
+void test_never_fires_early() {
+    const uint32_t delays_ms[] = {1, 9, 10, 11, 639, 640, 641, 1999, 60000, 3600000};
+    const uint32_t starts_ms[] = {0, 3, 5000, UINT32_MAX - 2000};  // Last one wraps
+    for (uint32_t start_ms : starts_ms) {
+        for (uint32_t delay_ms : delays_ms) {
+            Probe probe;
+            probe.now_ms = start_ms;
+            TimerWheel wheel(TICK_MS, start_ms);
+            wheel.schedule(start_ms, delay_ms, on_fire, &probe, 0);
+            run_for(wheel, probe, delay_ms + 2 * TICK_MS, 7);
+
+            uint32_t late_ms = probe.fired_at_ms - (start_ms + delay_ms);
+            TEST_ASSERT_EQUAL_UINT32(1, probe.fire_count);
+            TEST_ASSERT_TRUE_MESSAGE(late_ms < TICK_MS + 7, "fired early or too late");
+        }
+    }
+}
+
+void test_schedule_after_stall() {
+    // advance() has not run for 5 s when the timer is scheduled
+    Probe probe;
+    TimerWheel wheel(TICK_MS, 0);
+    probe.now_ms = 5000;
+    wheel.schedule(5000, 800, on_fire, &probe, 0);
+
+    wheel.advance(5000);
+    TEST_ASSERT_EQUAL_UINT32(0, probe.fire_count);
+    run_for(wheel, probe, 1000, 1);
+    TEST_ASSERT_EQUAL_UINT32(5800, probe.fired_at_ms);
+}
+
+void test_delay_longer_than_one_turn() {
+    const uint32_t turn_ms = TimerWheel::SLOT_COUNT * TICK_MS;
+    Probe probe;
+    TimerWheel wheel(TICK_MS, 0);
+    wheel.schedule(0, 3 * turn_ms + 50, on_fire, &probe, 0);
+
+    run_for(wheel, probe, 4 * turn_ms, TICK_MS);
+    TEST_ASSERT_EQUAL_UINT32(3 * turn_ms + 50, probe.fired_at_ms);
+}
+
+void test_cancel_with_stale_ids() {
+    Probe first;
+    Probe second;
+    TimerWheel wheel(TICK_MS, 0);
+
+    TimerWheel::TimerId fired = wheel.schedule(0, 10, on_fire, &first, 0);
+    first.now_ms = 10;
+    wheel.advance(10);
+    TEST_ASSERT_EQUAL_UINT32(1, first.fire_count);
+    TEST_ASSERT_FALSE(wheel.cancel(fired));
+
+    // The freed node is reused under a new generation
+    TimerWheel::TimerId reused = wheel.schedule(10, 10, on_fire, &second, 0);
+    TEST_ASSERT_TRUE(reused != fired);
+    TEST_ASSERT_FALSE(wheel.cancel(fired));
+    TEST_ASSERT_EQUAL(1u, wheel.active_count());
+
+    TEST_ASSERT_TRUE(wheel.cancel(reused));
+    TEST_ASSERT_FALSE(wheel.cancel(reused));
+    TEST_ASSERT_FALSE(wheel.cancel(TimerWheel::INVALID_TIMER));
+    second.now_ms = 100;
+    wheel.advance(100);
+    TEST_ASSERT_EQUAL_UINT32(0, second.fire_count);
+}
+
+void test_pool_exhaustion() {
+    Probe probe;
+    TimerWheel wheel(TICK_MS, 0);
+    TimerWheel::TimerId ids[TimerWheel::MAX_TIMERS];
+    for (uint16_t i = 0; i < TimerWheel::MAX_TIMERS; i++) {
+        ids[i] = wheel.schedule(0, 100, on_fire, &probe, i);
+        TEST_ASSERT_TRUE(ids[i] != TimerWheel::INVALID_TIMER);
+    }
+    TEST_ASSERT_EQUAL_UINT32(TimerWheel::INVALID_TIMER, wheel.schedule(0, 100, on_fire, &probe, 0));
+
+    TEST_ASSERT_TRUE(wheel.cancel(ids[3]));
+    TEST_ASSERT_TRUE(wheel.schedule(0, 100, on_fire, &probe, 0) != TimerWheel::INVALID_TIMER);
+    TEST_ASSERT_EQUAL(TimerWheel::MAX_TIMERS, wheel.active_count());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_rounds_up_to_whole_ticks);
+    RUN_TEST(test_never_fires_early);
+    RUN_TEST(test_schedule_after_stall);
+    RUN_TEST(test_delay_longer_than_one_turn);
+    RUN_TEST(test_cancel_with_stale_ids);
+    RUN_TEST(test_pool_exhaustion);
+    return UNITY_END();
+}